@@ -0,0 +1,214 @@
+/*
+  ==============================================================================
+
+    FastMathBenchmark.cpp
+    Created: 16 Oct 2026 7:58:40pm
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+//Accuracy and speed of FastMath against libm. Every function is swept over its whole
+//documented range (log2 and gainToDecibels over every 64th positive normal float),
+//the worst error is compared with the bound written in FastMath.h, and the array
+//versions are timed against the equivalent std:: loop. Exits with 1 if any bound is
+//broken, so it doubles as the accuracy test. --check skips the timing, that's what
+//ctest runs.
+//
+//  FastMathBenchmark [--check]
+
+#include <JuceHeader.h>
+#include "../Source/FastMath.h"
+#include <chrono>
+
+namespace {
+
+struct Check {
+    const char* name;
+    double worst;
+    double bound;
+    const char* kind;
+};
+
+std::vector<Check> checks;
+
+void report(const char* name, double worst, double bound, const char* kind) {
+    checks.push_back({ name, worst, bound, kind });
+}
+
+double relError(double approx, double exact) {
+    return exact == 0.0 ? std::abs(approx) : std::abs(approx - exact) / std::abs(exact);
+}
+
+//absolute near zero, relative once the result is big enough that float spacing dominates
+double mixedError(double approx, double exact) {
+    return std::abs(approx - exact) / juce::jmax(1.0, std::abs(exact));
+}
+
+template <typename Fn>
+void forEachNormalFloat(Fn&& fn) {
+    for (int64_t bits = 0x00800000; bits < 0x7f800000; bits += 64) {
+        float x;
+        const auto b = (int32_t)bits;
+        std::memcpy(&x, &b, sizeof(x));
+        fn(x);
+    }
+}
+
+void checkAccuracy() {
+    double worst = 0.0;
+    for (double x = -126.0; x <= 127.0; x += 1.0e-4)
+        worst = juce::jmax(worst, relError(FastMath::exp2((float)x), std::exp2((double)(float)x)));
+    report("exp2", worst, 3.0e-7, "relative");
+
+    worst = 0.0;
+    forEachNormalFloat([&](float x) { worst = juce::jmax(worst, mixedError(FastMath::log2(x), std::log2((double)x))); });
+    report("log2", worst, 1.5e-7, "absolute/relative");
+
+    worst = 0.0;
+    for (double db = -200.0; db <= 200.0; db += 1.0e-4) {
+        const auto d = (float)db;
+        worst = juce::jmax(worst, relError(FastMath::decibelsToGain(d, -1000.0f), std::pow(10.0, d / 20.0)));
+    }
+    report("decibelsToGain", worst, 2.0e-6, "relative");
+
+    worst = 0.0;
+    forEachNormalFloat([&](float x) {
+        worst = juce::jmax(worst, mixedError(FastMath::gainToDecibels(x, -1000.0f), 20.0 * std::log10((double)x)));
+    });
+    report("gainToDecibels", worst, 5.0e-7, "absolute (dB)/relative");
+
+    const std::pair<float, float> ranges[]{ { 20.0f, 20000.0f }, { 1.0f, 60.0f }, { 0.1f, 10.0f }, { 1.0e-3f, 1.0e3f } };
+    double worstTo = 0.0, worstFrom = 0.0;
+    for (auto [lo, hi] : ranges) {
+        for (int i = 0; i <= 1000000; ++i) {
+            const auto t = (float)(i / 1000000.0);
+            const auto exact = (double)lo * std::pow((double)hi / lo, (double)t);
+            worstTo = juce::jmax(worstTo, relError(FastMath::mapToLog10(t, lo, hi), exact));
+            const auto v = (float)exact;
+            worstFrom = juce::jmax(worstFrom, std::abs(FastMath::mapFromLog10(v, lo, hi) - std::log((double)v / lo) / std::log((double)hi / lo)));
+        }
+    }
+    report("mapToLog10", worstTo, 1.5e-6, "relative");
+    report("mapFromLog10", worstFrom, 2.0e-7, "absolute");
+
+    worst = 0.0;
+    juce::Random angles(0xa7a2);
+    for (int i = 0; i < 4000000; ++i) {
+        //every direction, magnitudes from 1e-20 to 1e20
+        const auto angle = (angles.nextDouble() * 2.0 - 1.0) * juce::MathConstants<double>::pi;
+        const auto magnitude = std::pow(10.0, angles.nextDouble() * 40.0 - 20.0);
+        const auto y = (float)(magnitude * std::sin(angle));
+        const auto x = (float)(magnitude * std::cos(angle));
+        const auto error = std::abs(FastMath::atan2(y, x) - std::atan2((double)y, (double)x));
+        //pi and -pi are the same direction
+        worst = juce::jmax(worst, juce::jmin(error, juce::MathConstants<double>::twoPi - error));
+    }
+    report("atan2", worst, 4.0e-7, "absolute (radians)");
+
+    worst = 0.0;
+    juce::Random random(0x5eed);
+    for (int i = 0; i < 4000000; ++i) {
+        //half of the points where designs live, half over the whole range
+        const auto x = (i & 1) ? random.nextDouble() * juce::MathConstants<double>::pi : (random.nextDouble() * 2.0 - 1.0) * 1.0e5;
+        double s, c;
+        FastMath::sinCos(x, s, c);
+        worst = juce::jmax(worst, std::abs(s - std::sin(x)), std::abs(c - std::cos(x)));
+    }
+    report("sinCos", worst, 2.5e-16, "absolute");
+
+    worst = 0.0;
+    for (int i = 1; i < 4000000; ++i) {
+        const auto x = (i / 4000000.0 * 2.0 - 1.0) * juce::MathConstants<double>::halfPi;
+        worst = juce::jmax(worst, relError(FastMath::tan(x), std::tan(x)));
+    }
+    report("tan", worst, 7.0e-16, "relative");
+}
+
+template <typename Fn>
+double nsPerValue(Fn&& fn, int num) {
+    using Clock = std::chrono::steady_clock;
+    //a few hundred ms per measurement, best of five
+    double best = 1.0e30;
+    for (int run = 0; run < 5; ++run) {
+        const auto start = Clock::now();
+        int reps = 0;
+        while (Clock::now() - start < std::chrono::milliseconds(60)) {
+            fn();
+            ++reps;
+        }
+        const auto ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+        best = juce::jmin(best, ns / (double(reps) * num));
+    }
+    return best;
+}
+
+void checkSpeed() {
+    constexpr int num = 4096;
+    std::vector<float> src(num), dst(num), dbs(num), gains(num);
+    juce::Random random(42);
+    for (int i = 0; i < num; ++i) {
+        src[(size_t)i] = random.nextFloat() * 1.0e3f + 1.0e-3f;
+        dbs[(size_t)i] = random.nextFloat() * 120.0f - 96.0f;
+        gains[(size_t)i] = random.nextFloat() * 4.0f;
+    }
+    float sink = 0.0f;
+
+    auto row = [&](const char* name, double fast, double libm) {
+        std::cout << "  " << name << ": " << fast << " ns vs " << libm << " ns (x" << libm / fast << ")\n";
+    };
+
+    std::cout << "speed per value, FastMath vs libm:\n";
+    row("log2 array",
+        nsPerValue([&] { FastMath::log2(dst.data(), src.data(), num); sink += dst[7]; }, num),
+        nsPerValue([&] { for (int i = 0; i < num; ++i) dst[(size_t)i] = std::log2(src[(size_t)i]); sink += dst[7]; }, num));
+    row("exp2 array",
+        nsPerValue([&] { FastMath::exp2(dst.data(), dbs.data(), num); sink += dst[7]; }, num),
+        nsPerValue([&] { for (int i = 0; i < num; ++i) dst[(size_t)i] = std::exp2(dbs[(size_t)i]); sink += dst[7]; }, num));
+    row("decibelsToGain array",
+        nsPerValue([&] { FastMath::decibelsToGain(dst.data(), dbs.data(), num); sink += dst[7]; }, num),
+        nsPerValue([&] { for (int i = 0; i < num; ++i) dst[(size_t)i] = juce::Decibels::decibelsToGain(dbs[(size_t)i]); sink += dst[7]; }, num));
+    row("gainToDecibels array",
+        nsPerValue([&] { FastMath::gainToDecibels(dst.data(), gains.data(), num); sink += dst[7]; }, num),
+        nsPerValue([&] { for (int i = 0; i < num; ++i) dst[(size_t)i] = juce::Decibels::gainToDecibels(gains[(size_t)i]); sink += dst[7]; }, num));
+    row("powerToDecibels array",
+        nsPerValue([&] { FastMath::powerToDecibels(dst.data(), src.data(), num); sink += dst[7]; }, num),
+        nsPerValue([&] { for (int i = 0; i < num; ++i) dst[(size_t)i] = 10.0f * std::log10(src[(size_t)i]); sink += dst[7]; }, num));
+    row("atan2 array",
+        nsPerValue([&] { FastMath::atan2(dst.data(), dbs.data(), src.data(), num); sink += dst[7]; }, num),
+        nsPerValue([&] { for (int i = 0; i < num; ++i) dst[(size_t)i] = std::atan2(dbs[(size_t)i], src[(size_t)i]); sink += dst[7]; }, num));
+    row("mapToLog10",
+        nsPerValue([&] { for (int i = 0; i < num; ++i) dst[(size_t)i] = FastMath::mapToLog10(gains[(size_t)i] * 0.25f, 20.0f, 20000.0f); sink += dst[7]; }, num),
+        nsPerValue([&] { for (int i = 0; i < num; ++i) dst[(size_t)i] = juce::mapToLog10(gains[(size_t)i] * 0.25f, 20.0f, 20000.0f); sink += dst[7]; }, num));
+
+    double dsink = 0.0;
+    row("sinCos (double)",
+        nsPerValue([&] { for (int i = 0; i < num; ++i) { double s, c; FastMath::sinCos(src[(size_t)i] * 1.0e-3, s, c); dsink += s + c; } }, num),
+        nsPerValue([&] { for (int i = 0; i < num; ++i) dsink += std::sin(src[(size_t)i] * 1.0e-3) + std::cos(src[(size_t)i] * 1.0e-3); }, num));
+    row("tan (double)",
+        nsPerValue([&] { for (int i = 0; i < num; ++i) dsink += FastMath::tan(src[(size_t)i] * 1.0e-3); }, num),
+        nsPerValue([&] { for (int i = 0; i < num; ++i) dsink += std::tan(src[(size_t)i] * 1.0e-3); }, num));
+
+    //keeps the optimiser from dropping the loops
+    if (sink == 1.2345f && dsink == 1.2345)
+        std::cout << "\n";
+}
+
+} //namespace
+
+int main(int argc, char* argv[]) {
+    juce::ArgumentList args(argc, argv);
+    checkAccuracy();
+
+    bool ok = true;
+    std::cout << "worst error over the full range:\n";
+    for (auto& c : checks) {
+        const bool pass = c.worst <= c.bound;
+        ok = ok && pass;
+        std::cout << "  " << c.name << ": " << c.worst << " " << c.kind << " (bound " << c.bound << ")" << (pass ? "" : "  FAILED") << "\n";
+    }
+
+    if (!args.containsOption("--check"))
+        checkSpeed();
+    return ok ? 0 : 1;
+}
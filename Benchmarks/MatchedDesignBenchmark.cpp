@@ -0,0 +1,175 @@
+/*
+  ==============================================================================
+
+    MatchedDesignBenchmark.cpp
+    Created: 16 Oct 2026 9:41:12pm
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+//Magnitude matched designs against the RBJ ones. Every band type is designed both ways
+//over the plugin's whole range (20 Hz to 20 kHz, Q 0.1 to 10, -72 to +12 dB) at 44.1 to
+//192 kHz and compared with its analog prototype:
+//
+//  match points   worst error of the matched design at DC, nyquist and the band frequency
+//                 (the high pass only at the band frequency), where FilterDesign.h says
+//                 the magnitude is exact. Bound maxMatchErrorDb
+//  poles          largest matched pole radius, every design has to be stable
+//  sweep          worst error of each over the audible band, wherever the prototype is
+//                 above -80 dB. Reported only, neither design is closer everywhere
+//  design time    ns per call of each factory
+//
+//Exits with 1 if a match point is out by more than the bound or a matched design is
+//unstable. --check skips the timing, that's what ctest runs.
+//
+//  MatchedDesignBenchmark [--check]
+
+#include <JuceHeader.h>
+#include "../Source/FilterDesign.h"
+#include <chrono>
+
+namespace {
+
+constexpr double maxMatchErrorDb = 0.01;
+
+const char* const typeNames[]{ "peak", "highpass", "lowpass", "highshelf", "lowshelf" };
+constexpr double sampleRates[]{ 44100.0, 48000.0, 96000.0, 192000.0 };
+constexpr double qualities[]{ 0.1, 0.3, 0.707, 1.0, 2.0, 5.0, 10.0 };
+constexpr double gainsDb[]{ -72.0, -24.0, -12.0, -6.0, -1.0, 1.0, 6.0, 12.0 };
+constexpr int numFrequencies = 31;
+
+//same numbering as the plugin's Type choice
+BiquadCoeffs designMatched(int type, double sampleRate, double freq, double Q, double gain) {
+    switch (type) {
+    case 0: return FilterDesign::makeMatchedPeakFilter(sampleRate, freq, Q, gain);
+    case 1: return FilterDesign::makeMatchedHighPass(sampleRate, freq, Q);
+    case 2: return FilterDesign::makeMatchedLowPass(sampleRate, freq, Q);
+    case 3: return FilterDesign::makeMatchedHighShelf(sampleRate, freq, Q, gain);
+    default: return FilterDesign::makeMatchedLowShelf(sampleRate, freq, Q, gain);
+    }
+}
+
+BiquadCoeffs designRbj(int type, double sampleRate, double freq, double Q, double gain) {
+    switch (type) {
+    case 0: return FilterDesign::makePeakFilter(sampleRate, freq, Q, gain);
+    case 1: return FilterDesign::makeHighPass(sampleRate, freq, Q);
+    case 2: return FilterDesign::makeLowPass(sampleRate, freq, Q);
+    case 3: return FilterDesign::makeHighShelf(sampleRate, freq, Q, gain);
+    default: return FilterDesign::makeLowShelf(sampleRate, freq, Q, gain);
+    }
+}
+
+//the RBJ cookbook's analog prototypes, omega is the frequency over the band frequency
+double analogMagnitude(int type, double omega, double Q, double gain) {
+    const auto A = std::sqrt(gain);
+    const auto rootA = std::sqrt(A);
+    double n2, n1, n0, d2, d1, d0;
+    switch (type) {
+    case 0:  n2 = 1.0;   n1 = A / Q;         n0 = 1.0;   d2 = 1.0; d1 = 1.0 / (A * Q); d0 = 1.0; break;
+    case 1:  n2 = 1.0;   n1 = 0.0;           n0 = 0.0;   d2 = 1.0; d1 = 1.0 / Q;       d0 = 1.0; break;
+    case 2:  n2 = 0.0;   n1 = 0.0;           n0 = 1.0;   d2 = 1.0; d1 = 1.0 / Q;       d0 = 1.0; break;
+    case 3:  n2 = A * A; n1 = A * rootA / Q; n0 = A;     d2 = 1.0; d1 = rootA / Q;     d0 = A;   break;
+    default: n2 = A;     n1 = A * rootA / Q; n0 = A * A; d2 = A;   d1 = rootA / Q;     d0 = 1.0; break;
+    }
+    const auto o2 = omega * omega;
+    return std::abs(std::complex<double>(n0 - n2 * o2, n1 * omega) / std::complex<double>(d0 - d2 * o2, d1 * omega));
+}
+
+double errorDb(double magnitude, double exact) {
+    return std::abs(20.0 * std::log10(juce::jmax(1.0e-30, magnitude) / juce::jmax(1.0e-30, exact)));
+}
+
+struct TypeResult {
+    double worstMatchDb = 0.0;
+    double worstPoleRadius = 0.0;
+    double worstSweepMatchedDb = 0.0;
+    double worstSweepRbjDb = 0.0;
+};
+
+template <typename Fn>
+void forEachDesign(Fn&& fn) {
+    for (auto sampleRate : sampleRates)
+        for (int i = 0; i < numFrequencies; ++i)
+            for (auto Q : qualities)
+                for (auto gainDb : gainsDb)
+                    for (int type = 0; type < 5; ++type)
+                        //the passes have no gain
+                        if ((type != 1 && type != 2) || gainDb == gainsDb[0])
+                            fn(type, sampleRate, juce::mapToLog10(i / double(numFrequencies - 1), 20.0, 20000.0), Q,
+                               juce::Decibels::decibelsToGain(gainDb, -100.0));
+}
+
+std::array<TypeResult, 5> checkAccuracy() {
+    std::array<TypeResult, 5> results;
+    forEachDesign([&](int type, double sampleRate, double freq, double Q, double gain) {
+        auto& result = results[(size_t)type];
+        const auto matched = designMatched(type, sampleRate, freq, Q, gain);
+        const auto rbj = designRbj(type, sampleRate, freq, Q, gain);
+        result.worstPoleRadius = juce::jmax(result.worstPoleRadius, matched.getPoleRadius());
+
+        //the band frequency is matched up to 0.95 nyquist, see getMatchFrequency
+        const auto matchFreq = juce::jmin(freq, 0.475 * sampleRate);
+        const auto nyquist = 0.5 * sampleRate;
+        for (auto f : { 0.0, nyquist, matchFreq }) {
+            if (type == 1 && f != matchFreq)
+                continue;
+            result.worstMatchDb = juce::jmax(result.worstMatchDb, errorDb(matched.getMagnitudeForFrequency(f, sampleRate), analogMagnitude(type, f / freq, Q, gain)));
+        }
+
+        const auto top = juce::jmin(20000.0, 0.45 * sampleRate);
+        for (int i = 0; i < 200; ++i) {
+            const auto f = juce::mapToLog10(i / 199.0, 20.0, top);
+            const auto exact = analogMagnitude(type, f / freq, Q, gain);
+            if (exact < 1.0e-4)
+                continue;
+            result.worstSweepMatchedDb = juce::jmax(result.worstSweepMatchedDb, errorDb(matched.getMagnitudeForFrequency(f, sampleRate), exact));
+            result.worstSweepRbjDb = juce::jmax(result.worstSweepRbjDb, errorDb(rbj.getMagnitudeForFrequency(f, sampleRate), exact));
+        }
+    });
+    return results;
+}
+
+template <typename Design>
+double nsPerDesign(Design&& design) {
+    using Clock = std::chrono::steady_clock;
+    //best of five runs of the whole sweep
+    double best = 1.0e30, sink = 0.0;
+    for (int run = 0; run < 5; ++run) {
+        int num = 0;
+        const auto start = Clock::now();
+        forEachDesign([&](int type, double sampleRate, double freq, double Q, double gain) {
+            sink += design(type, sampleRate, freq, Q, gain).b0;
+            ++num;
+        });
+        best = juce::jmin(best, std::chrono::duration<double, std::nano>(Clock::now() - start).count() / num);
+    }
+    //keeps the optimiser from dropping the loops
+    if (sink == 1.2345)
+        std::cout << "\n";
+    return best;
+}
+
+} //namespace
+
+int main(int argc, char* argv[]) {
+    juce::ArgumentList args(argc, argv);
+    const auto results = checkAccuracy();
+
+    bool ok = true;
+    std::cout << "worst error against the analog prototype (dB), matched vs RBJ:\n";
+    for (size_t type = 0; type < results.size(); ++type) {
+        const auto& r = results[type];
+        const bool pass = r.worstMatchDb <= maxMatchErrorDb && r.worstPoleRadius < 1.0;
+        ok = ok && pass;
+        std::cout << "  " << typeNames[type] << ": match points " << r.worstMatchDb << " (bound " << maxMatchErrorDb
+                  << "), pole radius " << r.worstPoleRadius << ", sweep " << r.worstSweepMatchedDb << " vs "
+                  << r.worstSweepRbjDb << (pass ? "" : "  FAILED") << "\n";
+    }
+
+    if (!args.containsOption("--check")) {
+        std::cout << "design time per call: matched " << nsPerDesign(designMatched) << " ns, RBJ "
+                  << nsPerDesign(designRbj) << " ns\n";
+    }
+    return ok ? 0 : 1;
+}
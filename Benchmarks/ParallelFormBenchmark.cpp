@@ -0,0 +1,272 @@
+/*
+  ==============================================================================
+
+    ParallelFormBenchmark.cpp
+    Created: 16 Oct 2026 6:48:03pm
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+//Speed and accuracy of the parallel (partial fraction) form against the cascade.
+//For each scenario it converts the band designs, times both engines in float on the
+//same noise, and compares both against a double precision cascade reference:
+//
+//  designErrorDb     worst deviation of the parallel response from the cascade's, in dB,
+//                    both evaluated in double (conversion error alone)
+//  cascadeErrorDb    worst float cascade output error relative to the signal RMS, in dB
+//  parallelErrorDb   the same for the float parallel form
+//
+//Scenarios the conversion refuses (nearly coincident or ill conditioned poles) are
+//reported with "converted": false, the plugin stays on the cascade for those.
+//
+//--check skips the timing and exits with 1 if any converted scenario has a designErrorDb
+//over maxDesignErrorDb, or a parallelErrorDb more than maxExtraErrorDb above the float
+//cascade's, or if nothing converted at all. That's what ctest runs.
+//
+//  ParallelFormBenchmark [--blocks=512] [--channels=2] [--seconds=0.2] [--check] [--output=file.json]
+
+#include <JuceHeader.h>
+#include "../Source/BiquadCascade.h"
+#include "../Source/ParallelFilterBank.h"
+#include "../Source/FilterDesign.h"
+
+namespace {
+
+constexpr int maxSections = 12;
+
+//a converted form has to match the cascade in double, and in float may lose a little
+//more than the cascade does but not a different order of error
+constexpr double maxDesignErrorDb = 1.0e-6;
+constexpr double maxExtraErrorDb = 6.0;
+
+struct Band {
+    int type;   //same numbering as the plugin's Type choice
+    double freq, gainDb, Q;
+};
+
+struct Scenario {
+    juce::String name;
+    double sampleRate;
+    std::vector<Band> bands;
+};
+
+BiquadCoeffs design(const Band& b, double sampleRate) {
+    const auto gain = juce::Decibels::decibelsToGain(b.gainDb, -80.0);
+    switch (b.type) {
+    case 0: return FilterDesign::makePeakFilter(sampleRate, b.freq, b.Q, gain);
+    case 1: return FilterDesign::makeHighPass(sampleRate, b.freq, b.Q);
+    case 2: return FilterDesign::makeLowPass(sampleRate, b.freq, b.Q);
+    case 3: return FilterDesign::makeHighShelf(sampleRate, b.freq, b.Q, gain);
+    default: return FilterDesign::makeLowShelf(sampleRate, b.freq, b.Q, gain);
+    }
+}
+
+SectionKind kindOf(int type) {
+    switch (type) {
+    case 0: return SectionKind::peak;
+    case 1: return SectionKind::highPass;
+    case 2: return SectionKind::lowPass;
+    default: return SectionKind::shelf;
+    }
+}
+
+std::vector<Scenario> makeScenarios() {
+    std::vector<Scenario> list;
+    for (auto sr : { 44100.0, 48000.0, 96000.0, 192000.0 }) {
+        const auto rate = juce::String((int)sr);
+        list.push_back({ "mix x8 @ " + rate, sr, {
+            { 1, 30.0, 0.0, 0.707 }, { 4, 120.0, 3.0, 0.707 }, { 0, 350.0, -4.0, 1.4 }, { 0, 900.0, 2.0, 0.8 },
+            { 0, 2500.0, -3.0, 2.0 }, { 0, 5000.0, 4.0, 1.0 }, { 3, 10000.0, 2.0, 0.707 }, { 2, 18000.0, 0.0, 0.707 } } });
+
+        Scenario peaks{ "peaks x12 @ " + rate, sr, {} };
+        for (int i = 0; i < maxSections; ++i)
+            peaks.bands.push_back({ 0, juce::mapToLog10(i / 11.0, 40.0, 16000.0), (i % 2 == 0) ? 6.0 : -6.0, 1.5 });
+        list.push_back(peaks);
+
+        list.push_back({ "low end @ " + rate, sr, {
+            { 1, 20.0, 0.0, 0.707 }, { 4, 60.0, 6.0, 0.707 }, { 0, 100.0, -6.0, 4.0 }, { 0, 180.0, 3.0, 2.0 } } });
+
+        list.push_back({ "close peaks @ " + rate, sr, {
+            { 0, 1000.0, 6.0, 8.0 }, { 0, 1010.0, -6.0, 8.0 }, { 0, 4000.0, 3.0, 1.0 } } });
+    }
+    return list;
+}
+
+struct Engines {
+    BiquadCascade<float, maxSections> cascade;
+    ParallelFilterBank<float, maxSections> parallel;
+    std::array<BiquadCoeffs, maxSections> coeffs;
+    std::array<ParallelSection, maxSections> sections;
+    double direct = 1.0;
+    int numBands = 0;
+    bool converted = false;
+};
+
+void setup(Engines& e, const Scenario& s, const juce::dsp::ProcessSpec& spec) {
+    e.numBands = (int)s.bands.size();
+    e.cascade.prepare(spec);
+    e.parallel.prepare(spec);
+    for (int i = 0; i < e.numBands; ++i) {
+        e.coeffs[(size_t)i] = design(s.bands[(size_t)i], s.sampleRate);
+        e.cascade.setCoefficients(i, e.coeffs[(size_t)i], kindOf(s.bands[(size_t)i].type));
+        e.cascade.setSectionEnabled(i, true);
+    }
+    e.sections.fill({});
+    e.converted = FilterDesign::makeParallelForm(e.coeffs.data(), e.numBands, e.direct, e.sections.data());
+    e.parallel.setDesign(e.direct, e.sections.data());
+}
+
+//conversion error on its own, both forms evaluated in double over a log grid
+double designErrorDb(const Engines& e, double sampleRate) {
+    double worst = 0.0;
+    for (int i = 0; i < 1000; ++i) {
+        const auto f = juce::mapToLog10(i / 999.0, 20.0, juce::jmin(20000.0, 0.49 * sampleRate));
+        const auto z = std::polar(1.0, -juce::MathConstants<double>::twoPi * f / sampleRate);
+        std::complex<double> cascade(1.0), parallel(e.direct);
+        for (int k = 0; k < e.numBands; ++k) {
+            const auto& c = e.coeffs[(size_t)k];
+            const auto& p = e.sections[(size_t)k];
+            cascade *= (c.b0 + z * (c.b1 + z * c.b2)) / (1.0 + z * (c.a1 + z * c.a2));
+            parallel += (p.b0 + z * p.b1) / (1.0 + z * (p.a1 + z * p.a2));
+        }
+        worst = juce::jmax(worst, std::abs(20.0 * std::log10(std::abs(parallel) / std::abs(cascade))));
+    }
+    return worst;
+}
+
+//float output error against a double cascade, relative to the reference RMS
+template <typename Engine>
+double outputErrorDb(Engine& engine, const Engines& e, const juce::AudioBuffer<float>& input, int blockSize) {
+    const auto numChannels = input.getNumChannels();
+    const auto numSamples = input.getNumSamples();
+    juce::AudioBuffer<float> output(input);
+
+    for (int start = 0; start < numSamples; start += blockSize) {
+        const auto num = juce::jmin(blockSize, numSamples - start);
+        juce::dsp::AudioBlock<float> block(output);
+        auto sub = block.getSubBlock((size_t)start, (size_t)num);
+        engine.process(juce::dsp::ProcessContextReplacing<float>(sub));
+    }
+
+    double maxError = 0.0, sumSquares = 0.0;
+    for (int ch = 0; ch < numChannels; ++ch) {
+        std::array<double, maxSections> z1{}, z2{};
+        for (int i = 0; i < numSamples; ++i) {
+            double x = input.getSample(ch, i);
+            for (int k = 0; k < e.numBands; ++k) {
+                const auto& c = e.coeffs[(size_t)k];
+                const auto y = c.b0 * x + z1[(size_t)k];
+                z1[(size_t)k] = c.b1 * x - c.a1 * y + z2[(size_t)k];
+                z2[(size_t)k] = c.b2 * x - c.a2 * y;
+                x = y;
+            }
+            maxError = juce::jmax(maxError, std::abs(x - (double)output.getSample(ch, i)));
+            sumSquares += x * x;
+        }
+    }
+    const auto rms = std::sqrt(sumSquares / double(numChannels * numSamples));
+    return 20.0 * std::log10(juce::jmax(1.0e-30, maxError) / juce::jmax(1.0e-30, rms));
+}
+
+template <typename Engine>
+double timeEngine(Engine& engine, juce::AudioBuffer<float>& buffer, const juce::AudioBuffer<float>& source, double seconds) {
+    const auto blockSize = buffer.getNumSamples();
+    const auto ticksPerSecond = (double)juce::Time::getHighResolutionTicksPerSecond();
+    const auto minTicks = (juce::int64)(seconds * ticksPerSecond);
+    int readPos = 0;
+    juce::int64 samples = 0;
+
+    const auto start = juce::Time::getHighResolutionTicks();
+    auto now = start;
+    do {
+        if (readPos + blockSize > source.getNumSamples())
+            readPos = 0;
+        for (int ch = 0; ch < buffer.getNumChannels(); ++ch)
+            buffer.copyFrom(ch, 0, source, ch, readPos, blockSize);
+        juce::dsp::AudioBlock<float> block(buffer);
+        engine.process(juce::dsp::ProcessContextReplacing<float>(block));
+        readPos += blockSize;
+        samples += blockSize;
+        now = juce::Time::getHighResolutionTicks();
+    } while (now - start < minTicks);
+
+    return 1.0e9 * double(now - start) / ticksPerSecond / double(samples);
+}
+
+} //namespace
+
+int main(int argc, char* argv[]) {
+    juce::ArgumentList args(argc, argv);
+    const int blockSize = args.containsOption("--blocks") ? args.getValueForOption("--blocks").getIntValue() : 512;
+    const int numChannels = juce::jlimit(1, 16, args.containsOption("--channels") ? args.getValueForOption("--channels").getIntValue() : 2);
+    const double seconds = args.containsOption("--seconds") ? args.getValueForOption("--seconds").getDoubleValue() : 0.2;
+    const bool check = args.containsOption("--check");
+
+    juce::Array<juce::var> results;
+    int numConverted = 0, numFailed = 0;
+    for (auto& scenario : makeScenarios()) {
+        const juce::dsp::ProcessSpec spec{ scenario.sampleRate, (juce::uint32)blockSize, (juce::uint32)numChannels };
+        Engines engines;
+        setup(engines, scenario, spec);
+
+        //one second of noise
+        juce::AudioBuffer<float> source(numChannels, (int)scenario.sampleRate);
+        juce::Random random(0x5eed);
+        for (int ch = 0; ch < numChannels; ++ch)
+            for (int i = 0; i < source.getNumSamples(); ++i)
+                source.setSample(ch, i, (random.nextFloat() * 2.0f - 1.0f) * 0.25f);
+
+        auto* entry = new juce::DynamicObject();
+        entry->setProperty("scenario", scenario.name);
+        entry->setProperty("sampleRate", scenario.sampleRate);
+        entry->setProperty("bands", engines.numBands);
+        entry->setProperty("converted", engines.converted);
+
+        engines.cascade.reset();
+        const auto cascadeError = outputErrorDb(engines.cascade, engines, source, blockSize);
+        entry->setProperty("cascadeErrorDb", cascadeError);
+        juce::AudioBuffer<float> buffer(numChannels, blockSize);
+        if (!check) {
+            engines.cascade.reset();
+            entry->setProperty("cascadeNsPerSample", timeEngine(engines.cascade, buffer, source, seconds));
+        }
+
+        bool failed = false;
+        if (engines.converted) {
+            ++numConverted;
+            const auto designError = designErrorDb(engines, scenario.sampleRate);
+            entry->setProperty("designErrorDb", designError);
+            engines.parallel.reset();
+            const auto parallelError = outputErrorDb(engines.parallel, engines, source, blockSize);
+            entry->setProperty("parallelErrorDb", parallelError);
+            if (!check) {
+                engines.parallel.reset();
+                entry->setProperty("parallelNsPerSample", timeEngine(engines.parallel, buffer, source, seconds));
+            }
+            failed = designError > maxDesignErrorDb || parallelError > cascadeError + maxExtraErrorDb;
+            numFailed += failed ? 1 : 0;
+        }
+
+        std::cerr << scenario.name << (engines.converted ? "" : " (not converted)") << (failed ? "  FAILED" : "") << "\n";
+        results.add(juce::var(entry));
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("blockSize", blockSize);
+    root->setProperty("channels", numChannels);
+    root->setProperty("simdLanes", (int)juce::dsp::SIMDRegister<float>::SIMDNumElements);
+    root->setProperty("results", results);
+
+    const auto json = juce::JSON::toString(juce::var(root));
+    if (args.containsOption("--output"))
+        juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output")).replaceWithText(json);
+    else
+        std::cout << json << "\n";
+
+    if (!check)
+        return 0;
+    if (numConverted == 0)
+        std::cerr << "no scenario converted\n";
+    return numConverted > 0 && numFailed == 0 ? 0 : 1;
+}
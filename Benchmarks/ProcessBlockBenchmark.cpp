@@ -0,0 +1,364 @@
+/*
+  ==============================================================================
+
+    ProcessBlockBenchmark.cpp
+    Created: 16 Oct 2026 4:12:37pm
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+//Headless processBlock timing. Builds the processor without an editor, sweeps band
+//count, band type, block size, sample rate and channel count, and writes one JSON
+//object per case. Every axis can be overridden from the command line, e.g.
+//
+//  ProcessBlockBenchmark --bands=0,6,12 --types=mixed --blocks=512 --rates=48000
+//                        --channels=2 --seconds=0.2 --output=results.json
+//
+//nsPerSample is wall time per sample frame (all channels), realtimeFactor is how
+//many times faster than realtime the case ran. --automate moves every active band's
+//frequency each block, an octave either way once a second, the way host automation
+//would; the redesigns on the parameter change are timed along with processBlock.
+//--smoothing=20 ramps those changes over that many ms (smoothing is off by default).
+//--svf runs every band on the state variable engine instead of biquads. --parallel runs
+//the parallel form instead of the cascade, rebuilding it wherever the bands are redesigned
+//(it's the builder thread's job in the plugin, here it's timed inline). --silence feeds
+//digital silence instead of noise, which times the idle path once the bands have rung out.
+//--double asks for double precision and runs the 64 bit processBlock, to compare against
+//the float path. --oversampling=1,2,4,8 repeats every case at each factor, to see what
+//running the filters at the higher rate costs. --linear-phase=short|medium|long runs the
+//convolver instead of the filters; each case then also times a kernel rebuild on the
+//calling thread (kernelBuildMs), and nsPerBlock gives the convolution cost per block.
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+
+namespace {
+
+struct Options {
+    juce::Array<int> bands{ 0, 1, 2, 4, 8, 12 };
+    juce::StringArray types{ "peak", "highpass", "lowpass", "highshelf", "lowshelf", "mixed" };
+    juce::Array<int> blocks{ 16, 64, 256, 1024, 8192 };
+    juce::Array<double> rates{ 44100.0, 48000.0, 96000.0, 192000.0 };
+    juce::Array<int> channels{ 1, 2, 6, 12, 16 };
+    juce::Array<int> oversampling{ 1 };
+    double seconds = 0.05;  //measured wall time per run
+    float smoothingMs = 0.0f;
+    int runs = 5;
+    bool analyser = false;
+    bool automate = false;
+    bool svf = false;
+    bool parallel = false;
+    bool silence = false;
+    bool doublePrecision = false;
+    int linearPhase = 0;    //choice index, 0 is off
+    juce::File output;
+};
+
+struct Result {
+    double nsPerSampleMedian = 0.0;
+    double nsPerSampleMin = 0.0;
+    int64_t samplesProcessed = 0;
+};
+
+//band type names map onto the "Type" choice, mixed cycles through all of them
+const juce::StringArray typeNames{ "peak", "highpass", "lowpass", "highshelf", "lowshelf" };
+const juce::StringArray linearPhaseNames{ "off", "short", "medium", "long" };
+
+template <typename T>
+juce::Array<T> parseList(const juce::String& text) {
+    juce::Array<T> list;
+    for (auto& token : juce::StringArray::fromTokens(text, ",", ""))
+        if (token.trim().isNotEmpty())
+            list.add(static_cast<T>(token.trim().getDoubleValue()));
+    return list;
+}
+
+bool parseOptions(const juce::ArgumentList& args, Options& options) {
+    if (args.containsOption("--help|-h")) {
+        std::cout << "usage: ProcessBlockBenchmark [--bands=0,1,12] [--types=peak,mixed] [--blocks=16,8192]\n"
+                     "                             [--rates=44100,192000] [--channels=1,2] [--seconds=0.05]\n"
+                     "                             [--runs=5] [--analyser] [--automate] [--smoothing=20] [--svf]\n"
+                     "                             [--parallel] [--silence] [--double] [--oversampling=1,2,4,8]\n"
+                     "                             [--linear-phase=short|medium|long] [--output=file.json]\n"
+                     "types: peak highpass lowpass highshelf lowshelf mixed\n";
+        return false;
+    }
+
+    if (args.containsOption("--bands"))    options.bands = parseList<int>(args.getValueForOption("--bands"));
+    if (args.containsOption("--blocks"))   options.blocks = parseList<int>(args.getValueForOption("--blocks"));
+    if (args.containsOption("--rates"))    options.rates = parseList<double>(args.getValueForOption("--rates"));
+    if (args.containsOption("--channels")) options.channels = parseList<int>(args.getValueForOption("--channels"));
+    if (args.containsOption("--seconds"))  options.seconds = args.getValueForOption("--seconds").getDoubleValue();
+    if (args.containsOption("--oversampling")) options.oversampling = parseList<int>(args.getValueForOption("--oversampling"));
+    if (args.containsOption("--runs"))     options.runs = args.getValueForOption("--runs").getIntValue();
+    if (args.containsOption("--smoothing")) options.smoothingMs = args.getValueForOption("--smoothing").getFloatValue();
+    if (args.containsOption("--types"))
+        options.types = juce::StringArray::fromTokens(args.getValueForOption("--types"), ",", "");
+    if (args.containsOption("--output"))
+        options.output = juce::File::getCurrentWorkingDirectory().getChildFile(args.getValueForOption("--output"));
+    options.analyser = args.containsOption("--analyser");
+    options.automate = args.containsOption("--automate");
+    options.svf = args.containsOption("--svf");
+    options.parallel = args.containsOption("--parallel");
+    options.silence = args.containsOption("--silence");
+    options.doublePrecision = args.containsOption("--double");
+    if (args.containsOption("--linear-phase")) {
+        const auto length = args.getValueForOption("--linear-phase").toLowerCase();
+        options.linearPhase = linearPhaseNames.indexOf(length);
+        if (options.linearPhase < 0) {
+            std::cerr << "unknown linear phase length: " << length << "\n";
+            return false;
+        }
+    }
+
+    for (auto factor : options.oversampling)
+        if (factor != 1 && factor != 2 && factor != 4 && factor != 8) {
+            std::cerr << "oversampling factor must be 1, 2, 4 or 8: " << factor << "\n";
+            return false;
+        }
+
+    options.types.removeEmptyStrings();
+    for (auto& type : options.types)
+        if (type != "mixed" && !typeNames.contains(type)) {
+            std::cerr << "unknown band type: " << type << "\n";
+            return false;
+        }
+
+    options.seconds = juce::jmax(0.001, options.seconds);
+    options.runs = juce::jmax(1, options.runs);
+    return true;
+}
+
+void setParam(ProceduralEqAudioProcessor& processor, const juce::String& id, float value) {
+    if (auto* param = processor.tree.getParameter(id))
+        param->setValueNotifyingHost(param->convertTo0to1(value));
+}
+
+float getBandFrequency(int band, int numBands) {
+    const auto norm = numBands > 1 ? float(band) / float(numBands - 1) : 0.5f;
+    return juce::mapToLog10(norm, 40.0f, 16000.0f);
+}
+
+//first numBands bands spread over the spectrum with alternating boosts and cuts, the rest off
+void setupBands(ProceduralEqAudioProcessor& processor, int numBands, const juce::String& type, bool svf) {
+    for (int i = 0; i < MAX_EQS; ++i) {
+        const bool active = i < numBands;
+        const int typeIndex = type == "mixed" ? i % typeNames.size() : typeNames.indexOf(type);
+
+        setParam(processor, params[0 + i * 6], getBandFrequency(i, numBands));
+        setParam(processor, params[1 + i * 6], (i % 2 == 0) ? 6.0f : -6.0f);
+        setParam(processor, params[2 + i * 6], 1.0f);
+        setParam(processor, params[3 + i * 6], (float)typeIndex);
+        setParam(processor, params[4 + i * 6], active ? 0.0f : 1.0f);
+        setParam(processor, params[5 + i * 6], active ? 1.0f : 0.0f);
+        setParam(processor, engineParams[i], svf ? 1.0f : 0.0f);
+    }
+}
+
+bool prepareProcessor(ProceduralEqAudioProcessor& processor, int numChannels, double sampleRate, int blockSize, bool doublePrecision) {
+    juce::AudioProcessor::BusesLayout layout;
+    layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+    layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+    if (!processor.setBusesLayout(layout))
+        return false;
+
+    processor.setProcessingPrecision(doublePrecision ? juce::AudioProcessor::doublePrecision : juce::AudioProcessor::singlePrecision);
+    processor.setRateAndBufferSizeDetails(sampleRate, blockSize);
+    processor.prepareToPlay(sampleRate, blockSize);
+    return true;
+}
+
+template <typename SampleType>
+Result runCase(ProceduralEqAudioProcessor& processor, int numBands, int numChannels, double sampleRate, int blockSize, const Options& options) {
+    //a second of noise to cycle through, copied in each block so the filters never settle to silence
+    const int sourceLength = juce::jmax(blockSize, (int)sampleRate);
+    juce::AudioBuffer<SampleType> source(numChannels, sourceLength);
+    source.clear();
+    juce::Random random(0x5eed);
+    for (int ch = 0; ch < numChannels && !options.silence; ++ch)
+        for (int i = 0; i < sourceLength; ++i)
+            source.setSample(ch, i, SampleType((random.nextFloat() * 2.0f - 1.0f) * 0.25f));
+
+    juce::AudioBuffer<SampleType> buffer(numChannels, blockSize);
+    juce::MidiBuffer midi;
+    int readPos = 0;
+    int64_t position = 0;
+
+    auto processOne = [&]() {
+        if (options.automate) {
+            const auto octaves = std::sin(juce::MathConstants<double>::twoPi * double(position) / sampleRate);
+            for (int i = 0; i < numBands; ++i)
+                setParam(processor, params[0 + i * 6], juce::jlimit(20.0f, 20000.0f, getBandFrequency(i, numBands) * (float)std::exp2(octaves)));
+            //the processor's timer would design them, there's no message loop here to run it
+            processor.drainDirtyBands();
+            if (options.parallel)
+                processor.getParallelFormBuilder()->build();
+            position += blockSize;
+        }
+        if (readPos + blockSize > sourceLength)
+            readPos = 0;
+        for (int ch = 0; ch < numChannels; ++ch)
+            buffer.copyFrom(ch, 0, source, ch, readPos, blockSize);
+        processor.processBlock(buffer, midi);
+        readPos += blockSize;
+    };
+
+    //warm up caches, branch predictors and any pending coefficient posts
+    for (int i = 0; i < juce::jmax(4, 16384 / blockSize); ++i)
+        processOne();
+
+    Result result;
+    std::vector<double> perRun;
+    const auto ticksPerSecond = (double)juce::Time::getHighResolutionTicksPerSecond();
+    const auto minTicks = (int64_t)(options.seconds * ticksPerSecond);
+
+    for (int run = 0; run < options.runs; ++run) {
+        int64_t samples = 0;
+        const auto start = juce::Time::getHighResolutionTicks();
+        auto now = start;
+        do {
+            processOne();
+            samples += blockSize;
+            now = juce::Time::getHighResolutionTicks();
+        } while (now - start < minTicks);
+
+        perRun.push_back(1.0e9 * double(now - start) / ticksPerSecond / double(samples));
+        result.samplesProcessed += samples;
+    }
+
+    std::sort(perRun.begin(), perRun.end());
+    result.nsPerSampleMedian = perRun[perRun.size() / 2];
+    result.nsPerSampleMin = perRun.front();
+    return result;
+}
+
+//median wall time of designing and posting a kernel for the current bands. The builder
+//thread normally does this, here it's run directly so the timing is on a known thread.
+//It also leaves the kernel for these bands in place before the case starts
+double timeKernelBuild(ProceduralEqAudioProcessor& processor, int runs) {
+    std::vector<double> perRun;
+    const auto ticksPerSecond = (double)juce::Time::getHighResolutionTicksPerSecond();
+    for (int run = 0; run < runs; ++run) {
+        const auto start = juce::Time::getHighResolutionTicks();
+        processor.getLinearPhaseBuilder()->build();
+        perRun.push_back(1.0e3 * double(juce::Time::getHighResolutionTicks() - start) / ticksPerSecond);
+    }
+    std::sort(perRun.begin(), perRun.end());
+    return perRun[perRun.size() / 2];
+}
+
+juce::var makeMachineInfo() {
+    auto* info = new juce::DynamicObject();
+    info->setProperty("cpu", juce::SystemStats::getCpuModel());
+    info->setProperty("numCpus", juce::SystemStats::getNumCpus());
+    info->setProperty("os", juce::SystemStats::getOperatingSystemName());
+    info->setProperty("juce", juce::SystemStats::getJUCEVersion());
+#if JUCE_DEBUG
+    info->setProperty("build", "debug");
+#else
+    info->setProperty("build", "release");
+#endif
+    return juce::var(info);
+}
+
+} //namespace
+
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    Options options;
+    if (!parseOptions(args, options))
+        return args.containsOption("--help|-h") ? 0 : 1;
+
+    juce::Array<juce::var> cases;
+    for (auto numChannels : options.channels) {
+        for (auto sampleRate : options.rates) {
+            for (auto blockSize : options.blocks) {
+                //fresh processor per layout so nothing carries over between cases
+                ProceduralEqAudioProcessor processor;
+                setParam(processor, "analyserOn", options.analyser ? 1.0f : 0.0f);
+                setParam(processor, "smoothingTime", options.smoothingMs);
+                setParam(processor, "linearPhase", (float)options.linearPhase);
+                setParam(processor, "filterStructure", options.parallel ? 1.0f : 0.0f);
+                if (!prepareProcessor(processor, numChannels, sampleRate, blockSize, options.doublePrecision)) {
+                    std::cerr << "skipping unsupported layout: " << numChannels << " channels\n";
+                    continue;
+                }
+
+                for (auto factor : options.oversampling) {
+                    //the choice index is log2 of the factor
+                    setParam(processor, "oversampling", (float)juce::jlimit(0, MAX_OVERSAMPLING_ORDER, juce::roundToInt(std::log2(factor))));
+                    for (auto& type : options.types) {
+                        for (auto numBands : options.bands) {
+                            numBands = juce::jlimit(0, MAX_EQS, numBands);
+                            setupBands(processor, numBands, type, options.svf);
+                            //the bands are only marked by the param changes, the kernel build below wants them designed
+                            processor.drainDirtyBands();
+                            if (options.parallel)
+                                processor.getParallelFormBuilder()->build();
+                            const auto kernelBuildMs = options.linearPhase > 0 ? timeKernelBuild(processor, options.runs) : 0.0;
+                            //each case starts from clear filter, oversampler and convolver states
+                            processor.reset();
+
+                            const auto result = options.doublePrecision
+                                              ? runCase<double>(processor, numBands, numChannels, sampleRate, blockSize, options)
+                                              : runCase<float>(processor, numBands, numChannels, sampleRate, blockSize, options);
+                            const auto nsPerSecondOfAudio = result.nsPerSampleMedian * sampleRate;
+
+                            auto* entry = new juce::DynamicObject();
+                            entry->setProperty("bands", numBands);
+                            entry->setProperty("type", type);
+                            entry->setProperty("blockSize", blockSize);
+                            entry->setProperty("sampleRate", sampleRate);
+                            entry->setProperty("channels", numChannels);
+                            entry->setProperty("oversampling", factor);
+                            //there's no message loop here to pass it on to getLatencySamples
+                            entry->setProperty("latencySamples", processor.getRunningLatencySamples());
+                            entry->setProperty("nsPerSample", result.nsPerSampleMedian);
+                            entry->setProperty("nsPerSampleMin", result.nsPerSampleMin);
+                            entry->setProperty("nsPerBlock", result.nsPerSampleMedian * blockSize);
+                            if (options.linearPhase > 0)
+                                entry->setProperty("kernelBuildMs", kernelBuildMs);
+                            entry->setProperty("nsPerChannelSample", result.nsPerSampleMedian / numChannels);
+                            entry->setProperty("realtimeFactor", nsPerSecondOfAudio > 0.0 ? 1.0e9 / nsPerSecondOfAudio : 0.0);
+                            entry->setProperty("samplesProcessed", result.samplesProcessed);
+                            cases.add(juce::var(entry));
+
+                            std::cerr << numChannels << "ch " << sampleRate << " Hz, block " << blockSize << ", "
+                                      << numBands << " x " << type << ", " << factor << "x: " << result.nsPerSampleMedian << " ns/sample\n";
+                        }
+                    }
+                }
+                processor.releaseResources();
+            }
+        }
+    }
+
+    auto* root = new juce::DynamicObject();
+    root->setProperty("machine", makeMachineInfo());
+    root->setProperty("secondsPerRun", options.seconds);
+    root->setProperty("runs", options.runs);
+    root->setProperty("analyser", options.analyser);
+    root->setProperty("automate", options.automate);
+    root->setProperty("smoothingMs", options.smoothingMs);
+    root->setProperty("engine", options.svf ? "svf" : "biquad");
+    root->setProperty("structure", options.parallel ? "parallel" : "serial");
+    root->setProperty("silence", options.silence);
+    root->setProperty("precision", options.doublePrecision ? "double" : "float");
+    root->setProperty("linearPhase", linearPhaseNames[options.linearPhase]);
+    root->setProperty("results", cases);
+
+    const auto json = juce::JSON::toString(juce::var(root));
+    if (options.output != juce::File()) {
+        if (!options.output.replaceWithText(json)) {
+            std::cerr << "couldn't write " << options.output.getFullPathName() << "\n";
+            return 1;
+        }
+    }
+    else {
+        std::cout << json << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,241 @@
+/*
+  ==============================================================================
+
+    BiquadCascade.h
+    Created: 16 Oct 2026 9:41:12am
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "FilterDesign.h"
+
+//Shape of a section's numerator, lets the cascade pick a kernel that skips the
+//multiplies the RBJ designs make redundant (b0 == b2 and b1 == +-2 * b0 for the
+//cuts, b1 == a1 for the peak). Shelves use the generic kernel, svf sections run the
+//trapezoidal state variable filter instead of a biquad.
+enum class SectionKind { peak, highPass, lowPass, shelf, svf };
+
+//==============================================================================
+/**
+*/
+//Runs every band of the eq as one cascade of transposed direct form II biquads.
+//Coefficients and states are kept as structure of arrays, and the channels of the
+//buffer are interleaved into SIMD lanes so a stereo pair (or up to a full register
+//of channels) is filtered with a single instruction stream. Blocks are worked through
+//in sub-blocks small enough that the interleaved data stays in L1 across all sections.
+template <typename SampleType, int NumSections>
+class BiquadCascade {
+public:
+    using Register = juce::dsp::SIMDRegister<SampleType>;
+    static constexpr size_t lanes = Register::SIMDNumElements;
+    static constexpr size_t subBlockSize = 256;
+
+    BiquadCascade() {
+        for (int i = 0; i < NumSections; ++i)
+            setIdentity(i);
+    }
+
+    void prepare(const juce::dsp::ProcessSpec& spec) {
+        numGroups = ((size_t)spec.numChannels + lanes - 1) / lanes;
+        interleaved.assign(juce::jmin((size_t)spec.maximumBlockSize, subBlockSize), Register::expand(SampleType(0)));
+        state1.assign(numGroups * NumSections, Register::expand(SampleType(0)));
+        state2.assign(numGroups * NumSections, Register::expand(SampleType(0)));
+    }
+
+    void reset() {
+        std::fill(state1.begin(), state1.end(), Register::expand(SampleType(0)));
+        std::fill(state2.begin(), state2.end(), Register::expand(SampleType(0)));
+    }
+
+    void setCoefficients(int section, const BiquadCoeffs& c, SectionKind kind = SectionKind::shelf) {
+        jassert(section >= 0 && section < NumSections && kind != SectionKind::svf);
+        setKind(section, kind);
+        b0[section] = Register::expand(static_cast<SampleType>(c.b0));
+        b1[section] = Register::expand(static_cast<SampleType>(c.b1));
+        b2[section] = Register::expand(static_cast<SampleType>(c.b2));
+        a1[section] = Register::expand(static_cast<SampleType>(c.a1));
+        a2[section] = Register::expand(static_cast<SampleType>(c.a2));
+    }
+
+    //an svf section keeps m0, m1, m2 where a biquad has b0, b1, b2, and a1, a2, a3 in a1, a2, a3
+    void setCoefficients(int section, const SvfCoeffs& c) {
+        jassert(section >= 0 && section < NumSections);
+        setKind(section, SectionKind::svf);
+        b0[section] = Register::expand(static_cast<SampleType>(c.m0));
+        b1[section] = Register::expand(static_cast<SampleType>(c.m1));
+        b2[section] = Register::expand(static_cast<SampleType>(c.m2));
+        a1[section] = Register::expand(static_cast<SampleType>(c.a1));
+        a2[section] = Register::expand(static_cast<SampleType>(c.a2));
+        a3[section] = Register::expand(static_cast<SampleType>(c.a3));
+    }
+
+    //rebuilds the compacted list of sections that are run, call only when a band changes
+    void setSectionEnabled(int section, bool shouldBeEnabled) {
+        jassert(section >= 0 && section < NumSections);
+        if (enabled[section] == shouldBeEnabled)
+            return;
+
+        //a band coming back in starts from silence instead of whatever it held when it left
+        if (shouldBeEnabled)
+            resetSection(section);
+
+        enabled[section] = shouldBeEnabled;
+        numActive = 0;
+        for (int s = 0; s < NumSections; ++s)
+            if (enabled[s])
+                activeSections[numActive++] = s;
+    }
+
+    int getNumActiveSections() const { return numActive; }
+
+    //inputGain and outputGain are applied while the channels are copied in and out of
+    //the lanes, which costs nothing on top of the copy the cascade has to make anyway
+    void process(const juce::dsp::ProcessContextReplacing<SampleType>& context,
+                 SampleType inputGain = SampleType(1), SampleType outputGain = SampleType(1)) {
+        auto& block = context.getOutputBlock();
+        const auto numChannels = block.getNumChannels();
+        const auto numSamples = block.getNumSamples();
+        jassert(numChannels <= numGroups * lanes);
+        jassert(!interleaved.empty()); //prepare() first
+
+        if (context.isBypassed || numSamples == 0 || interleaved.empty())
+            return;
+
+        //nothing to filter, only the gains are left
+        if (numActive == 0) {
+            const auto gain = inputGain * outputGain;
+            if (gain != SampleType(1))
+                block.multiplyBy(gain);
+            return;
+        }
+
+        for (size_t start = 0; start < numSamples; start += interleaved.size()) {
+            const auto num = juce::jmin(interleaved.size(), numSamples - start);
+            auto sub = block.getSubBlock(start, num);
+
+            for (size_t group = 0; group < numGroups && group * lanes < numChannels; ++group) {
+                const auto firstChannel = group * lanes;
+                const auto groupChannels = juce::jmin(lanes, numChannels - firstChannel);
+
+                interleave(sub, firstChannel, groupChannels, num, inputGain);
+                for (int n = 0; n < numActive; ++n) {
+                    const auto s = activeSections[n];
+                    switch (kinds[s]) {
+                    case SectionKind::peak:     processSection<SectionKind::peak>(s, group, num); break;
+                    case SectionKind::highPass: processSection<SectionKind::highPass>(s, group, num); break;
+                    case SectionKind::lowPass:  processSection<SectionKind::lowPass>(s, group, num); break;
+                    case SectionKind::svf:      processSection<SectionKind::svf>(s, group, num); break;
+                    default:                    processSection<SectionKind::shelf>(s, group, num); break;
+                    }
+                }
+                deinterleave(sub, firstChannel, groupChannels, num, outputGain);
+            }
+        }
+    }
+
+private:
+    void resetSection(int section) {
+        for (size_t group = 0; group < numGroups; ++group) {
+            state1[group * NumSections + (size_t)section] = Register::expand(SampleType(0));
+            state2[group * NumSections + (size_t)section] = Register::expand(SampleType(0));
+        }
+    }
+
+    //biquad and svf states don't mean the same thing, so a section changing between them starts clean
+    void setKind(int section, SectionKind kind) {
+        if ((kinds[section] == SectionKind::svf) != (kind == SectionKind::svf))
+            resetSection(section);
+        kinds[section] = kind;
+    }
+
+    void setIdentity(int section) {
+        b0[section] = Register::expand(SampleType(1));
+        b1[section] = b2[section] = a1[section] = a2[section] = a3[section] = Register::expand(SampleType(0));
+    }
+
+    void interleave(const juce::dsp::AudioBlock<SampleType>& block, size_t firstChannel, size_t groupChannels, size_t numSamples, SampleType gain) {
+        auto* raw = reinterpret_cast<SampleType*>(interleaved.data());
+        for (size_t ch = 0; ch < lanes; ++ch) {
+            if (ch < groupChannels) {
+                auto* src = block.getChannelPointer(firstChannel + ch);
+                for (size_t i = 0; i < numSamples; ++i)
+                    raw[i * lanes + ch] = src[i] * gain;
+            }
+            else {
+                //unused lanes stay silent so they never build up state
+                for (size_t i = 0; i < numSamples; ++i)
+                    raw[i * lanes + ch] = SampleType(0);
+            }
+        }
+    }
+
+    void deinterleave(juce::dsp::AudioBlock<SampleType>& block, size_t firstChannel, size_t groupChannels, size_t numSamples, SampleType gain) {
+        auto* raw = reinterpret_cast<const SampleType*>(interleaved.data());
+        for (size_t ch = 0; ch < groupChannels; ++ch) {
+            auto* dst = block.getChannelPointer(firstChannel + ch);
+            for (size_t i = 0; i < numSamples; ++i)
+                dst[i] = raw[i * lanes + ch] * gain;
+        }
+    }
+
+    template <SectionKind Kind>
+    void processSection(int s, size_t group, size_t numSamples) {
+        const auto idx = group * NumSections + (size_t)s;
+        auto z1 = state1[idx];
+        auto z2 = state2[idx];
+        const auto cb0 = b0[s], cb1 = b1[s], cb2 = b2[s], ca1 = a1[s], ca2 = a2[s], ca3 = a3[s];
+
+        auto* data = interleaved.data();
+        for (size_t i = 0; i < numSamples; ++i) {
+            const auto x = data[i];
+            if constexpr (Kind == SectionKind::lowPass || Kind == SectionKind::highPass) {
+                const auto bx = cb0 * x;
+                const auto y = bx + z1;
+                if constexpr (Kind == SectionKind::lowPass)
+                    z1 = (bx + bx) - ca1 * y + z2;
+                else
+                    z1 = z2 - (bx + bx) - ca1 * y;
+                z2 = bx - ca2 * y;
+                data[i] = y;
+            }
+            else if constexpr (Kind == SectionKind::svf) {
+                //z1 and z2 are the band and low integrator states
+                const auto v3 = x - z2;
+                const auto v1 = ca1 * z1 + ca2 * v3;
+                const auto v2 = z2 + ca2 * z1 + ca3 * v3;
+                z1 = (v1 + v1) - z1;
+                z2 = (v2 + v2) - z2;
+                data[i] = cb0 * x + cb1 * v1 + cb2 * v2;
+            }
+            else if constexpr (Kind == SectionKind::peak) {
+                const auto y = cb0 * x + z1;
+                z1 = ca1 * (x - y) + z2;
+                z2 = cb2 * x - ca2 * y;
+                data[i] = y;
+            }
+            else {
+                const auto y = cb0 * x + z1;
+                z1 = cb1 * x - ca1 * y + z2;
+                z2 = cb2 * x - ca2 * y;
+                data[i] = y;
+            }
+        }
+        state1[idx] = z1;
+        state2[idx] = z2;
+    }
+
+    //structure of arrays, each coefficient pre-broadcast across all lanes
+    std::array<Register, NumSections> b0, b1, b2, a1, a2, a3;
+    std::array<SectionKind, NumSections> kinds{};
+    std::array<bool, NumSections> enabled{};
+    std::array<int, NumSections> activeSections{};
+    int numActive = 0;
+
+    //states are laid out [group][section]
+    std::vector<Register> state1, state2;
+    std::vector<Register> interleaved;  //one sub-block
+    size_t numGroups = 0;
+};
@@ -0,0 +1,170 @@
+/*
+  ==============================================================================
+
+    FastMath.h
+    Created: 16 Oct 2026 7:31:15pm
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//Cheap replacements for the libm calls on the eq's hot paths. The float functions only
+//use integer tricks, polynomials and selects, no branches or libm calls, so the array
+//versions vectorize. The double ones are for filter design: one reduction gives sin and
+//cos together, with libm's accuracy over the range the designs use and the same result
+//on every platform. Error bounds are the worst cases Benchmarks/FastMathBenchmark
+//measures over each function's full range (it fails if any of them is exceeded), where
+//"abs/rel" means absolute for results below 1 and relative above:
+//
+//  exp2(x)            x in [-126, 127]           relative error < 3.0e-7
+//  log2(x)            x positive, normal         abs/rel error  < 1.5e-7
+//  decibelsToGain     db in [-200, 200]          relative error < 2.0e-6
+//  gainToDecibels     gain positive, normal      abs/rel error  < 5.0e-7 (dB)
+//  mapToLog10         proportion in [0, 1]       relative error < 1.5e-6
+//  mapFromLog10       value in [min, max]        absolute error < 2.0e-7
+//  atan2(y, x)        any finite y, x            absolute error < 4.0e-7 (radians)
+//  sinCos(x)          |x| <= 1e5 (double)        absolute error < 2.5e-16
+//  tan(x)             |x| < pi/2 (double)        relative error < 7.0e-16
+namespace FastMath {
+
+namespace detail {
+    inline float fromBits(int32_t bits) noexcept { float f; std::memcpy(&f, &bits, sizeof(f)); return f; }
+    inline int32_t toBits(float f) noexcept { int32_t bits; std::memcpy(&bits, &f, sizeof(bits)); return bits; }
+
+    constexpr double twoOverPi = 0.63661977236758134308;
+    constexpr double piOver2Hi = 1.57079632673412561417e+00;   //first 33 bits of pi/2
+    constexpr double piOver2Lo = 6.07710050650619224932e-11;   //pi/2 - piOver2Hi
+}
+
+//2^x, split into a power of two built in the exponent bits and a degree 6 polynomial
+//for 2^f with f in [-0.5, 0.5]. Adding 1.5 * 2^23 rounds x to an integer inside the
+//mantissa, so there's no libm call or float compare and the array loops vectorize.
+//Outside [-126, 127] the exponent saturates, giving roughly 2^-126 and 2^127
+inline float exp2(float x) noexcept {
+    const auto shifted = x + 12582912.0f;
+    const auto k = shifted - 12582912.0f;
+    const auto f = x - k;
+    const auto exponent = std::min(std::max(detail::toBits(shifted) - 0x4b400000, -126), 127);
+    const auto p = 1.0f + f * (0.69314718f + f * (0.24022651f + f * (0.055504109f
+                 + f * (0.0096181291f + f * (0.0013333558f + f * 0.00015403530f)))));
+    return p * detail::fromBits((exponent + 127) << 23);
+}
+
+//log2(x) for positive normal x, anything smaller is treated as the smallest normal.
+//Subtracting the bits of sqrt(1/2) before taking the exponent leaves the mantissa in
+//[sqrt(1/2), sqrt(2)), and log2(m) comes from the atanh series in t = (m - 1) / (m + 1),
+//|t| < 0.172. Integer ops only up to there, for the same reason as exp2
+inline float log2(float x) noexcept {
+    const auto bits = std::max(detail::toBits(x), 0x00800000);
+    const auto e = (bits - 0x3f3504f3) >> 23;
+    const auto m = detail::fromBits(bits - (e << 23));
+
+    const auto t = (m - 1.0f) / (m + 1.0f);
+    const auto t2 = t * t;
+    return (float)e + t * (2.8853901f + t2 * (0.96179669f + t2 * (0.57707802f + t2 * (0.41219858f + t2 * 0.32059890f))));
+}
+
+inline float exp(float x) noexcept { return exp2(x * 1.44269504f); }
+inline float log10(float x) noexcept { return log2(x) * 0.30103000f; }
+
+//same conventions as juce::Decibels, anything at or below minusInfinityDb is silence
+inline float decibelsToGain(float db, float minusInfinityDb = -100.0f) noexcept {
+    return db > minusInfinityDb ? exp2(db * 0.16609640f) : 0.0f;
+}
+
+inline float gainToDecibels(float gain, float minusInfinityDb = -100.0f) noexcept {
+    return gain > 0.0f ? juce::jmax(minusInfinityDb, log2(gain) * 6.0205999f) : minusInfinityDb;
+}
+
+//0..1 to a log scale between min and max and back, like juce::mapToLog10/mapFromLog10
+inline float mapToLog10(float proportion, float min, float max) noexcept {
+    return min * exp2(proportion * log2(max / min));
+}
+
+inline float mapFromLog10(float value, float min, float max) noexcept {
+    return log2(value / min) / log2(max / min);
+}
+
+//atan2 from one octant: a = min(|x|, |y|) / max(|x|, |y|) is in [0, 1], atan(a) there is a
+//degree 15 odd polynomial (fitted, 3.8e-8 off), and the octant and quadrant are put back
+//with the sign bit of y and two selects, which compile to blends so the array version
+//still vectorizes. On the axes it's exactly 0, pi/2 or pi like std::atan2, except that an
+//x of -0 counts as positive
+inline float atan2(float y, float x) noexcept {
+    const auto ax = std::abs(x);
+    const auto ay = std::abs(y);
+    const auto a = std::min(ax, ay) / std::max(std::max(ax, ay), 1.0e-30f);
+    const auto s = a * a;
+    auto r = a * (0.999999336f + s * (-0.333298608f + s * (0.199465656f + s * (-0.139086294f
+           + s * (0.0964219686f + s * (-0.0559123195f + s * (0.0218629524f + s * -0.00405456559f)))))));
+    r = ay > ax ? 1.57079637f - r : r;
+    r = x < 0.0f ? 3.14159274f - r : r;
+    return detail::fromBits(detail::toBits(r) | (detail::toBits(y) & (int32_t)0x80000000));
+}
+
+//whole arrays at a time, dest and src may be the same
+inline void exp2(float* dest, const float* src, int num) noexcept {
+    for (int i = 0; i < num; ++i)
+        dest[i] = exp2(src[i]);
+}
+
+inline void log2(float* dest, const float* src, int num) noexcept {
+    for (int i = 0; i < num; ++i)
+        dest[i] = log2(src[i]);
+}
+
+inline void decibelsToGain(float* dest, const float* src, int num, float minusInfinityDb = -100.0f) noexcept {
+    for (int i = 0; i < num; ++i) {
+        //masked rather than selected, so the loop vectorizes
+        const auto mask = -(int32_t)(src[i] > minusInfinityDb);
+        dest[i] = detail::fromBits(detail::toBits(exp2(src[i] * 0.16609640f)) & mask);
+    }
+}
+
+inline void gainToDecibels(float* dest, const float* src, int num, float minusInfinityDb = -100.0f) noexcept {
+    for (int i = 0; i < num; ++i)
+        dest[i] = std::max(minusInfinityDb, log2(src[i]) * 6.0205999f);
+}
+
+//10 * log10(power), for spectra
+inline void powerToDecibels(float* dest, const float* src, int num, float minusInfinityDb = -100.0f) noexcept {
+    for (int i = 0; i < num; ++i)
+        dest[i] = std::max(minusInfinityDb, log2(src[i]) * 3.0103000f);
+}
+
+//dest may be y or x
+inline void atan2(float* dest, const float* y, const float* x, int num) noexcept {
+    for (int i = 0; i < num; ++i)
+        dest[i] = atan2(y[i], x[i]);
+}
+
+//sin and cos together for filter design. Cody-Waite reduction to [-pi/4, pi/4] and
+//Taylor polynomials, which are already below double rounding at that width
+inline void sinCos(double x, double& s, double& c) noexcept {
+    const auto q = (x * detail::twoOverPi + 6755399441055744.0) - 6755399441055744.0;   //round to nearest
+    const auto r = (x - q * detail::piOver2Hi) - q * detail::piOver2Lo;
+    const auto r2 = r * r;
+
+    const auto sr = r + r * r2 * (-1.0 / 6.0 + r2 * (1.0 / 120.0 + r2 * (-1.0 / 5040.0 + r2 * (1.0 / 362880.0
+                  + r2 * (-1.0 / 39916800.0 + r2 * (1.0 / 6227020800.0 + r2 * (-1.0 / 1307674368000.0)))))));
+    const auto cr = 1.0 + r2 * (-0.5 + r2 * (1.0 / 24.0 + r2 * (-1.0 / 720.0 + r2 * (1.0 / 40320.0
+                  + r2 * (-1.0 / 3628800.0 + r2 * (1.0 / 479001600.0 + r2 * (-1.0 / 87178291200.0
+                  + r2 * (1.0 / 20922789888000.0))))))));
+
+    //rotate by the quadrant without branching, the designs' angles cross quadrants at random
+    const auto quadrant = (int64_t)q;
+    const auto odd = (quadrant & 1) != 0;
+    s = (odd ? cr : sr) * ((quadrant & 2) ? -1.0 : 1.0);
+    c = (odd ? sr : cr) * (((quadrant + 1) & 2) ? -1.0 : 1.0);
+}
+
+inline double tan(double x) noexcept {
+    double s, c;
+    sinCos(x, s, c);
+    return s / c;
+}
+
+} //namespace FastMath
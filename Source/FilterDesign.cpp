@@ -0,0 +1,391 @@
+/*
+  ==============================================================================
+
+    FilterDesign.cpp
+    Created: 16 Oct 2026 11:02:37am
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#include "FilterDesign.h"
+#include "FastMath.h"
+
+static BiquadCoeffs normalise(double b0, double b1, double b2, double a0, double a1, double a2) noexcept {
+    jassert(a0 != 0.0);
+    const auto a0inv = 1.0 / a0;
+    return { b0 * a0inv, b1 * a0inv, b2 * a0inv, a1 * a0inv, a2 * a0inv };
+}
+
+double BiquadCoeffs::getMagnitudeForFrequency(double frequency, double sampleRate) const noexcept {
+    jassert(sampleRate > 0.0);
+    const auto w = juce::MathConstants<double>::twoPi * frequency / sampleRate;
+    double c1, s1, c2, s2;
+    FastMath::sinCos(w, s1, c1);
+    FastMath::sinCos(2.0 * w, s2, c2);
+
+    const auto numRe = b0 + b1 * c1 + b2 * c2;
+    const auto numIm = b1 * s1 + b2 * s2;
+    const auto denRe = 1.0 + a1 * c1 + a2 * c2;
+    const auto denIm = a1 * s1 + a2 * s2;
+
+    return std::sqrt((numRe * numRe + numIm * numIm) / (denRe * denRe + denIm * denIm));
+}
+
+double BiquadCoeffs::getPoleRadius() const noexcept {
+    //poles of z^2 + a1 z + a2, a complex pair shares the radius sqrt(a2)
+    const auto disc = a1 * a1 - 4.0 * a2;
+    if (disc < 0.0)
+        return std::sqrt(a2);
+
+    const auto root = std::sqrt(disc);
+    return juce::jmax(std::abs(-a1 + root), std::abs(-a1 - root)) * 0.5;
+}
+
+BiquadCoeffs FilterDesign::makeIdentity() noexcept {
+    return {};
+}
+
+BiquadCoeffs FilterDesign::makePeakFilter(double sampleRate, double frequency, double Q, double gainFactor) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && frequency <= sampleRate * 0.5 && Q > 0.0 && gainFactor > 0.0);
+    const auto A = juce::jmax(0.0, std::sqrt(gainFactor));
+    const auto omega = juce::MathConstants<double>::twoPi * juce::jmax(frequency, 2.0) / sampleRate;
+    double sino, coso;
+    FastMath::sinCos(omega, sino, coso);
+    const auto alpha = sino / (Q * 2.0);
+    const auto c2 = -2.0 * coso;
+    const auto alphaTimesA = alpha * A;
+    const auto alphaOverA = alpha / A;
+
+    return normalise(1.0 + alphaTimesA, c2, 1.0 - alphaTimesA,
+                     1.0 + alphaOverA, c2, 1.0 - alphaOverA);
+}
+
+BiquadCoeffs FilterDesign::makeHighPass(double sampleRate, double frequency, double Q) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && frequency <= sampleRate * 0.5 && Q > 0.0);
+    const auto n = FastMath::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    const auto nSquared = n * n;
+    const auto invQ = 1.0 / Q;
+    const auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+    return { c1, c1 * -2.0, c1,
+             c1 * 2.0 * (nSquared - 1.0), c1 * (1.0 - invQ * n + nSquared) };
+}
+
+BiquadCoeffs FilterDesign::makeLowPass(double sampleRate, double frequency, double Q) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && frequency <= sampleRate * 0.5 && Q > 0.0);
+    const auto n = 1.0 / FastMath::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+    const auto nSquared = n * n;
+    const auto invQ = 1.0 / Q;
+    const auto c1 = 1.0 / (1.0 + invQ * n + nSquared);
+
+    return { c1, c1 * 2.0, c1,
+             c1 * 2.0 * (1.0 - nSquared), c1 * (1.0 - invQ * n + nSquared) };
+}
+
+BiquadCoeffs FilterDesign::makeHighShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && frequency <= sampleRate * 0.5 && Q > 0.0);
+    const auto A = juce::jmax(0.0, std::sqrt(gainFactor));
+    const auto aminus1 = A - 1.0;
+    const auto aplus1 = A + 1.0;
+    const auto omega = juce::MathConstants<double>::twoPi * juce::jmax(frequency, 2.0) / sampleRate;
+    double sino, coso;
+    FastMath::sinCos(omega, sino, coso);
+    const auto beta = sino * std::sqrt(A) / Q;
+    const auto aminus1TimesCoso = aminus1 * coso;
+
+    return normalise(A * (aplus1 + aminus1TimesCoso + beta),
+                     A * -2.0 * (aminus1 + aplus1 * coso),
+                     A * (aplus1 + aminus1TimesCoso - beta),
+                     aplus1 - aminus1TimesCoso + beta,
+                     2.0 * (aminus1 - aplus1 * coso),
+                     aplus1 - aminus1TimesCoso - beta);
+}
+
+BiquadCoeffs FilterDesign::makeLowShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && frequency <= sampleRate * 0.5 && Q > 0.0);
+    const auto A = juce::jmax(0.0, std::sqrt(gainFactor));
+    const auto aminus1 = A - 1.0;
+    const auto aplus1 = A + 1.0;
+    const auto omega = juce::MathConstants<double>::twoPi * juce::jmax(frequency, 2.0) / sampleRate;
+    double sino, coso;
+    FastMath::sinCos(omega, sino, coso);
+    const auto beta = sino * std::sqrt(A) / Q;
+    const auto aminus1TimesCoso = aminus1 * coso;
+
+    return normalise(A * (aplus1 - aminus1TimesCoso + beta),
+                     A * 2.0 * (aminus1 - aplus1 * coso),
+                     A * (aplus1 - aminus1TimesCoso - beta),
+                     aplus1 + aminus1TimesCoso + beta,
+                     -2.0 * (aminus1 + aplus1 * coso),
+                     aplus1 + aminus1TimesCoso - beta);
+}
+
+//g is the prewarped integrator gain tan(w / 2), k the damping (1 / Q)
+static SvfCoeffs makeSvf(double g, double k, double m0, double m1, double m2) noexcept {
+    const auto a1 = 1.0 / (1.0 + g * (g + k));
+    const auto a2 = g * a1;
+    return { a1, a2, g * a2, m0, m1, m2 };
+}
+
+static double prewarp(double sampleRate, double frequency) noexcept {
+    return FastMath::tan(juce::MathConstants<double>::pi * frequency / sampleRate);
+}
+
+SvfCoeffs FilterDesign::makeSvfPeakFilter(double sampleRate, double frequency, double Q, double gainFactor) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && frequency <= sampleRate * 0.5 && Q > 0.0 && gainFactor > 0.0);
+    const auto A = juce::jmax(0.0, std::sqrt(gainFactor));
+    const auto k = 1.0 / (Q * A);
+    return makeSvf(prewarp(sampleRate, juce::jmax(frequency, 2.0)), k, 1.0, k * (A * A - 1.0), 0.0);
+}
+
+SvfCoeffs FilterDesign::makeSvfHighPass(double sampleRate, double frequency, double Q) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && frequency <= sampleRate * 0.5 && Q > 0.0);
+    const auto k = 1.0 / Q;
+    return makeSvf(prewarp(sampleRate, frequency), k, 1.0, -k, -1.0);
+}
+
+SvfCoeffs FilterDesign::makeSvfLowPass(double sampleRate, double frequency, double Q) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && frequency <= sampleRate * 0.5 && Q > 0.0);
+    return makeSvf(prewarp(sampleRate, frequency), 1.0 / Q, 0.0, 0.0, 1.0);
+}
+
+SvfCoeffs FilterDesign::makeSvfHighShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && frequency <= sampleRate * 0.5 && Q > 0.0);
+    const auto A = juce::jmax(0.0, std::sqrt(gainFactor));
+    const auto k = 1.0 / Q;
+    return makeSvf(prewarp(sampleRate, juce::jmax(frequency, 2.0)) * std::sqrt(A), k, A * A, k * (1.0 - A) * A, 1.0 - A * A);
+}
+
+SvfCoeffs FilterDesign::makeSvfLowShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && frequency <= sampleRate * 0.5 && Q > 0.0);
+    const auto A = juce::jmax(0.0, std::sqrt(gainFactor));
+    const auto k = 1.0 / Q;
+    return makeSvf(prewarp(sampleRate, juce::jmax(frequency, 2.0)) / std::sqrt(A), k, 1.0, k * (A - 1.0), A * A - 1.0);
+}
+
+//analog prototype (n2 s^2 + n1 s + n0) / (d2 s^2 + d1 s + d0), s normalised to the band frequency
+struct AnalogSection {
+    double n2, n1, n0, d2, d1, d0;
+
+    double getMagnitudeSquared(double omega) const noexcept {
+        const auto o2 = omega * omega;
+        const auto numRe = n0 - n2 * o2, numIm = n1 * omega;
+        const auto denRe = d0 - d2 * o2, denIm = d1 * omega;
+        return (numRe * numRe + numIm * numIm) / (denRe * denRe + denIm * denIm);
+    }
+};
+
+//poles of the analog section through z = exp(sT), w0 is the band frequency in radians per sample
+static void matchPoles(double w0, const AnalogSection& h, double& a1, double& a2) noexcept {
+    //monic denominator s^2 + p s + q, poles at w0 (-p/2 +- sqrt(p^2/4 - q))
+    const auto p = h.d1 / h.d2, q = h.d0 / h.d2;
+    const auto decay = std::exp(-0.5 * p * w0);
+    const auto disc = q - 0.25 * p * p;
+    if (disc >= 0.0) {
+        double s, c;
+        FastMath::sinCos(w0 * std::sqrt(disc), s, c);
+        a1 = -2.0 * decay * c;
+    }
+    else {
+        a1 = -2.0 * decay * std::cosh(w0 * std::sqrt(-disc));
+    }
+    a2 = decay * decay;
+}
+
+//the third point the magnitude is matched at, the band frequency itself unless it's right
+//up at nyquist where phi2 goes to zero
+static double getMatchFrequency(double w0) noexcept {
+    return juce::jmin(w0, 0.95 * juce::MathConstants<double>::pi);
+}
+
+//Vicanek's matching. The numerator is fitted in the squared magnitude,
+//|B|^2 = B0 phi0 + B1 phi1 + B2 phi2 with phi1 = sin^2(w/2), phi0 = 1 - phi1 and
+//phi2 = 4 phi0 phi1, so matching the analog magnitude at DC, nyquist and one more
+//frequency is three linear equations for B0, B1, B2
+static BiquadCoeffs makeMatched(double sampleRate, double frequency, const AnalogSection& h) noexcept {
+    const auto w0 = juce::MathConstants<double>::twoPi * juce::jmax(frequency, 2.0) / sampleRate;
+    double a1, a2;
+    matchPoles(w0, h, a1, a2);
+
+    const auto A0 = (1.0 + a1 + a2) * (1.0 + a1 + a2);
+    const auto A1 = (1.0 - a1 + a2) * (1.0 - a1 + a2);
+    const auto A2 = -4.0 * a2;
+
+    const auto wm = getMatchFrequency(w0);
+    double sm, cm;
+    FastMath::sinCos(0.5 * wm, sm, cm);
+    const auto phi1 = sm * sm;
+    const auto phi0 = 1.0 - phi1;
+    const auto phi2 = 4.0 * phi0 * phi1;
+
+    const auto B0 = h.getMagnitudeSquared(0.0) * A0;
+    const auto B1 = h.getMagnitudeSquared(juce::MathConstants<double>::pi / w0) * A1;
+    const auto B2 = (h.getMagnitudeSquared(wm / w0) * (A0 * phi0 + A1 * phi1 + A2 * phi2) - B0 * phi0 - B1 * phi1) / phi2;
+
+    //back from the squared magnitude to b0, b1, b2, taking the minimum phase zeros
+    const auto root0 = std::sqrt(B0), root1 = std::sqrt(B1);
+    const auto W = 0.5 * (root0 + root1);
+    const auto b0 = 0.5 * (W + std::sqrt(juce::jmax(0.0, W * W + B2)));
+    const auto b1 = 0.5 * (root0 - root1);
+    const auto b2 = -B2 / (4.0 * b0);
+    return { b0, b1, b2, a1, a2 };
+}
+
+//1 / H, stable because the matched numerators are minimum phase
+static BiquadCoeffs invert(const BiquadCoeffs& c) noexcept {
+    return normalise(1.0, c.a1, c.a2, c.b0, c.b1, c.b2);
+}
+
+//a cut's poles are damped by 1 / A as much as a boost's, broad enough near nyquist that the
+//fit breaks down. A cut is the inverse of the boost by the same amount, so the boost is matched
+BiquadCoeffs FilterDesign::makeMatchedPeakFilter(double sampleRate, double frequency, double Q, double gainFactor) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && Q > 0.0 && gainFactor > 0.0);
+    if (gainFactor < 1.0)
+        return invert(makeMatchedPeakFilter(sampleRate, frequency, Q, 1.0 / gainFactor));
+
+    const auto A = juce::jmax(0.0, std::sqrt(gainFactor));
+    return makeMatched(sampleRate, frequency, { 1.0, A / Q, 1.0, 1.0, 1.0 / (A * Q), 1.0 });
+}
+
+//keeps the double zero at DC, so only the gain is left to match, at the band frequency
+BiquadCoeffs FilterDesign::makeMatchedHighPass(double sampleRate, double frequency, double Q) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && Q > 0.0);
+    const AnalogSection h{ 1.0, 0.0, 0.0, 1.0, 1.0 / Q, 1.0 };
+    const auto w0 = juce::MathConstants<double>::twoPi * juce::jmax(frequency, 2.0) / sampleRate;
+    double a1, a2;
+    matchPoles(w0, h, a1, a2);
+
+    const auto wm = getMatchFrequency(w0);
+    double sm, cm, s2, c2;
+    FastMath::sinCos(wm, sm, cm);
+    FastMath::sinCos(2.0 * wm, s2, c2);
+    const auto denRe = 1.0 + a1 * cm + a2 * c2, denIm = a1 * sm + a2 * s2;
+    //|1 - 2 z^-1 + z^-2| = 4 sin^2(w / 2) = 2 (1 - cos w)
+    const auto b0 = std::sqrt(h.getMagnitudeSquared(wm / w0) * (denRe * denRe + denIm * denIm)) / (2.0 * (1.0 - cm));
+    return { b0, -2.0 * b0, b0, a1, a2 };
+}
+
+BiquadCoeffs FilterDesign::makeMatchedLowPass(double sampleRate, double frequency, double Q) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && Q > 0.0);
+    return makeMatched(sampleRate, frequency, { 0.0, 0.0, 1.0, 1.0, 1.0 / Q, 1.0 });
+}
+
+//a boost's poles sit above the band frequency, past nyquist near the top where impulse
+//invariance can't follow them. A boost is the inverse of the cut by the same amount, whose
+//poles are below, so that's what gets matched
+BiquadCoeffs FilterDesign::makeMatchedHighShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && Q > 0.0 && gainFactor > 0.0);
+    if (gainFactor > 1.0)
+        return invert(makeMatchedHighShelf(sampleRate, frequency, Q, 1.0 / gainFactor));
+
+    const auto A = juce::jmax(0.0, std::sqrt(gainFactor));
+    const auto rootA = std::sqrt(A);
+    return makeMatched(sampleRate, frequency, { A * A, A * rootA / Q, A, 1.0, rootA / Q, A });
+}
+
+//the mirror image, a cut is the inverse of the matched boost
+BiquadCoeffs FilterDesign::makeMatchedLowShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept {
+    jassert(sampleRate > 0.0 && frequency > 0.0 && Q > 0.0 && gainFactor > 0.0);
+    if (gainFactor < 1.0)
+        return invert(makeMatchedLowShelf(sampleRate, frequency, Q, 1.0 / gainFactor));
+
+    const auto A = juce::jmax(0.0, std::sqrt(gainFactor));
+    const auto rootA = std::sqrt(A);
+    return makeMatched(sampleRate, frequency, { A, A * rootA / Q, A * A, A, rootA / Q, 1.0 });
+}
+
+//inverts the bilinear transform the svf is built on. With s = (1 / g)(1 - z^-1)/(1 + z^-1)
+//the denominator gives g from A(1) / A(-1) and k from 1 - a2, and the numerator's values
+//at z = 1, z = -1 and b0 - b2 give its analog coefficients, which map onto m0, m1, m2
+SvfCoeffs FilterDesign::makeSvfFromBiquad(const BiquadCoeffs& c) noexcept {
+    const auto atDc = 1.0 + c.a1 + c.a2, atNyquist = 1.0 - c.a1 + c.a2;
+    jassert(atDc > 0.0 && atNyquist > 0.0);  //stable, no pole on the real axis at +-1
+    const auto g = std::sqrt(atDc / atNyquist);
+    const auto d0 = 4.0 / atNyquist;
+    const auto k = (1.0 - c.a2) * d0 / (2.0 * g);
+
+    const auto n0 = (c.b0 + c.b1 + c.b2) * d0 / (4.0 * g * g);
+    const auto n1 = (c.b0 - c.b2) * d0 / (2.0 * g);
+    const auto n2 = (c.b0 - c.b1 + c.b2) * d0 / 4.0;
+    return makeSvf(g, k, n2, n1 - n2 * k, n0 - n2);
+}
+
+//Residue of the whole cascade at each pole p of section k is
+//  prod_j B_j(p) / ((1 - q/p) prod_{j != k} A_j(p))
+//with q the other pole of section k, then each section's two residues are folded back
+//into a real second order branch over its own denominator. The direct term is the
+//value as z^-1 goes to infinity, the product of b2/a2.
+bool FilterDesign::makeParallelForm(const BiquadCoeffs* sections, int numSections, double& direct, ParallelSection* out) {
+    using Complex = std::complex<double>;
+    constexpr double minPoleRadius = 1.0e-3;
+    constexpr double minPoleDistance = 1.0e-3;
+    constexpr double maxResidue = 1.0e3;
+
+    direct = 1.0;
+    if (numSections <= 0)
+        return true;
+    jassert(numSections <= maxParallelSections);
+    if (numSections > maxParallelSections)
+        return false;
+
+    std::array<std::array<Complex, 2>, maxParallelSections> poles;
+    for (int k = 0; k < numSections; ++k) {
+        const auto& c = sections[k];
+        const auto root = std::sqrt(Complex(c.a1 * c.a1 - 4.0 * c.a2, 0.0));
+        poles[(size_t)k] = { 0.5 * (-c.a1 + root), 0.5 * (-c.a1 - root) };
+        for (auto& p : poles[(size_t)k])
+            if (std::abs(p) < minPoleRadius)
+                return false;
+    }
+
+    //repeated poles have no simple partial fraction, nearly repeated ones blow the residues up
+    for (int k = 0; k < numSections; ++k)
+        for (int i = 0; i < 2; ++i)
+            for (int j = k; j < numSections; ++j)
+                for (int l = (j == k ? i + 1 : 0); l < 2; ++l)
+                    if (std::abs(poles[(size_t)k][(size_t)i] - poles[(size_t)j][(size_t)l]) < minPoleDistance)
+                        return false;
+
+    auto evaluate = [](double c0, double c1, double c2, Complex zInv) {
+        return c0 + zInv * (c1 + zInv * c2);
+    };
+
+    std::array<ParallelSection, maxParallelSections> branches;
+    double directTerm = 1.0;
+    for (int k = 0; k < numSections; ++k) {
+        const auto& own = sections[k];
+        directTerm *= own.b2 / own.a2;
+
+        Complex residue[2];
+        for (int i = 0; i < 2; ++i) {
+            const auto p = poles[(size_t)k][(size_t)i];
+            const auto q = poles[(size_t)k][(size_t)(1 - i)];
+            const auto zInv = 1.0 / p;
+
+            Complex num(1.0, 0.0), den = 1.0 - q * zInv;
+            for (int j = 0; j < numSections; ++j) {
+                const auto& c = sections[j];
+                num *= evaluate(c.b0, c.b1, c.b2, zInv);
+                if (j != k)
+                    den *= evaluate(1.0, c.a1, c.a2, zInv);
+            }
+            residue[i] = num / den;
+        }
+
+        auto& branch = branches[(size_t)k];
+        branch.b0 = (residue[0] + residue[1]).real();
+        branch.b1 = -(residue[0] * poles[(size_t)k][1] + residue[1] * poles[(size_t)k][0]).real();
+        branch.a1 = own.a1;
+        branch.a2 = own.a2;
+
+        //large cancelling residues lose too much precision once they're run in float
+        if (!std::isfinite(branch.b0) || !std::isfinite(branch.b1)
+            || std::abs(branch.b0) > maxResidue || std::abs(branch.b1) > maxResidue)
+            return false;
+    }
+
+    direct = directTerm;
+    std::copy_n(branches.begin(), numSections, out);
+    return true;
+}
@@ -0,0 +1,82 @@
+/*
+  ==============================================================================
+
+    FilterDesign.h
+    Created: 16 Oct 2026 11:02:37am
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//Normalised second order section (a0 == 1). Plain data so it can be designed,
+//copied between threads and handed to the audio thread without touching the heap.
+struct BiquadCoeffs {
+    double b0 = 1.0, b1 = 0.0, b2 = 0.0, a1 = 0.0, a2 = 0.0;
+
+    double getMagnitudeForFrequency(double frequency, double sampleRate) const noexcept;
+    //largest pole magnitude, how fast the section rings out (below 1 when stable)
+    double getPoleRadius() const noexcept;
+};
+
+//One branch of a parallel (partial fraction) form, (b0 + b1 z^-1) / (1 + a1 z^-1 + a2 z^-2)
+struct ParallelSection {
+    double b0 = 0.0, b1 = 0.0, a1 = 0.0, a2 = 0.0;
+};
+
+//Trapezoidal (topology preserving) state variable filter in Simper's form. a1..a3 advance
+//the two integrators, the output mixes input, band and low as m0 x + m1 v1 + m2 v2. The
+//integrator states mean something physically, so coefficients can change every sample
+//without the transients a direct form gets. The defaults pass the input straight through.
+struct SvfCoeffs {
+    double a1 = 1.0, a2 = 0.0, a3 = 0.0;
+    double m0 = 1.0, m1 = 0.0, m2 = 0.0;
+};
+
+//Allocation free versions of JUCE's IIR::Coefficients factories, same RBJ math,
+//gain arguments are linear gain factors like the JUCE ones
+namespace FilterDesign {
+    BiquadCoeffs makeIdentity() noexcept;
+    BiquadCoeffs makePeakFilter(double sampleRate, double frequency, double Q, double gainFactor) noexcept;
+    BiquadCoeffs makeHighPass(double sampleRate, double frequency, double Q) noexcept;
+    BiquadCoeffs makeLowPass(double sampleRate, double frequency, double Q) noexcept;
+    BiquadCoeffs makeHighShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept;
+    BiquadCoeffs makeLowShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept;
+
+    //SVF versions of the same five responses (identical magnitude and phase, the RBJ designs
+    //are bilinear too). Each costs one tan and a handful of multiplies, so modulating a band
+    //is much cheaper than a full redesign
+    SvfCoeffs makeSvfPeakFilter(double sampleRate, double frequency, double Q, double gainFactor) noexcept;
+    SvfCoeffs makeSvfHighPass(double sampleRate, double frequency, double Q) noexcept;
+    SvfCoeffs makeSvfLowPass(double sampleRate, double frequency, double Q) noexcept;
+    SvfCoeffs makeSvfHighShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept;
+    SvfCoeffs makeSvfLowShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept;
+
+    //Magnitude matched versions of the same five analog prototypes (Vicanek, "Matched Second
+    //Order Digital Filters"). No bilinear warping, so no cramping towards nyquist: the
+    //magnitude is exact at DC, nyquist and the band frequency and follows the analog curve
+    //in between, where RBJ pulls high bands down towards nyquist. Poles come from impulse
+    //invariance. Only the high pass keeps an RBJ numerator symmetry
+    BiquadCoeffs makeMatchedPeakFilter(double sampleRate, double frequency, double Q, double gainFactor) noexcept;
+    BiquadCoeffs makeMatchedHighPass(double sampleRate, double frequency, double Q) noexcept;
+    BiquadCoeffs makeMatchedLowPass(double sampleRate, double frequency, double Q) noexcept;
+    BiquadCoeffs makeMatchedHighShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept;
+    BiquadCoeffs makeMatchedLowShelf(double sampleRate, double frequency, double Q, double gainFactor) noexcept;
+
+    //the svf with the same transfer function as a stable biquad, so the svf engine can run
+    //designs that aren't bilinear
+    SvfCoeffs makeSvfFromBiquad(const BiquadCoeffs& c) noexcept;
+
+    //most sections makeParallelForm takes, its scratch is sized for this so it never allocates
+    inline constexpr int maxParallelSections = 12;
+
+    //Rewrites a cascade as direct + sum of first order over second order sections. Branch i
+    //keeps the poles of cascade section i, so out needs numSections entries. Returns false
+    //(and leaves a unity direct term) when poles sit too close together or too near the
+    //origin for the residues to be well conditioned, the cascade should be used then.
+    //Also false for more than maxParallelSections. A form it returns matches the cascade's
+    //response to within 1e-6 dB, ParallelFormBenchmark --check holds it to that.
+    bool makeParallelForm(const BiquadCoeffs* sections, int numSections, double& direct, ParallelSection* out);
+}
@@ -0,0 +1,135 @@
+/*
+  ==============================================================================
+
+    LinearPhaseBuilder.cpp
+    Created: 16 Oct 2026 11:37:48am
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#include "LinearPhaseBuilder.h"
+#include "PluginProcessor.h"
+
+LinearPhaseBuilder::LinearPhaseBuilder(ProceduralEqAudioProcessor& p, juce::TimeSliceThread& t) : audioProcessor(p), thread(t) {}
+
+LinearPhaseBuilder::~LinearPhaseBuilder() {
+    //waits for a build that's already running
+    thread.removeTimeSliceClient(this);
+}
+
+//switching off is a change of length too, so the kernel is handed back once. A build that's
+//running is still on the thread's list and isn't queued twice, if it read the bands before
+//the latest drain the next call finds it out of date and queues it again
+void LinearPhaseBuilder::update() {
+    const int length = audioProcessor.getLinearPhaseLength();
+    if (builtLength.load() != length || (length > 0 && builtGeneration.load() != audioProcessor.getDesignGeneration()))
+        thread.addTimeSliceClient(this);
+}
+
+//one build per wake up, then off the thread's list until update queues it again
+int LinearPhaseBuilder::useTimeSlice() {
+    build();
+    return -1;
+}
+
+bool LinearPhaseBuilder::build() {
+    const juce::ScopedLock sl(lock);
+    //read before the bands, anything posted after this is built next time round
+    const auto generation = audioProcessor.getDesignGeneration();
+    const int length = audioProcessor.getLinearPhaseLength();
+    if (length == 0)
+        audioProcessor.setLinearPhaseKernel(nullptr, 0);
+    //left unrecorded until the convolver fits, update then finds this out of date again
+    if (!audioProcessor.sizeLinearPhaseConvolver(length))
+        return false;
+
+    builtGeneration = generation;
+    builtLength = length;
+    if (length == 0) {
+        releaseScratch();
+        return false;
+    }
+
+    //the bins are at the host rate, the bands were designed at the oversampled one
+    std::array<BiquadCoeffs, MAX_EQS> active;
+    int numActive = 0;
+    double designRate = audioProcessor.getDesignSampleRate();
+    for (int band = 0; band < MAX_EQS; ++band) {
+        BandDesign bandDesign;
+        audioProcessor.getGuiDesign(band, bandDesign);
+        if (!bandDesign.active)
+            continue;
+
+        //caught a drain halfway through a new rate, its generation brings us back
+        if (numActive > 0 && bandDesign.designRate != designRate)
+            return false;
+        designRate = bandDesign.designRate;
+        active[(size_t)numActive++] = bandDesign.coeffs;
+    }
+
+    design(length, audioProcessor.getHostSampleRate(), designRate, active.data(), numActive);
+    audioProcessor.setLinearPhaseKernel(kernel.data(), length);
+    return true;
+}
+
+//frequency sampling: the magnitude at every bin of a length point FFT, zero phase, inverse
+//transformed. That's centred on length / 2 and windowed, and as the window's first tap is
+//zero the kernel is symmetric about its centre and delays everything by exactly length / 2
+void LinearPhaseBuilder::design(int length, double sampleRate, double designRate, const BiquadCoeffs* bands, int numBands) {
+    jassert(juce::isPowerOfTwo(length));
+    const int numBins = length / 2 + 1;
+    if (fft == nullptr || fft->getSize() != length) {
+        fft = std::make_unique<juce::dsp::FFT>(juce::roundToInt(std::log2(length)));
+        power.resize((size_t)numBins);
+        fftData.resize(2 * (size_t)length);
+        kernel.resize((size_t)length);
+
+        //periodic Blackman, -58 dB sidelobes keep the stopbands of the cuts clean
+        window.resize((size_t)length);
+        for (int n = 0; n < length; ++n) {
+            const auto phase = juce::MathConstants<double>::twoPi * n / length;
+            window[(size_t)n] = (float)(0.42 - 0.5 * std::cos(phase) + 0.08 * std::cos(2.0 * phase));
+        }
+    }
+
+    cosines.resize((size_t)numBins);
+    for (int k = 0; k < numBins; ++k)
+        cosines[(size_t)k] = std::cos(juce::MathConstants<double>::twoPi * k * sampleRate / (length * designRate));
+
+    std::fill(power.begin(), power.end(), 1.0);
+    for (int band = 0; band < numBands; ++band) {
+        //|b0 + b1 z^-1 + b2 z^-2|^2 on the unit circle is n0 + n1 cos w + n2 cos 2w
+        const auto& c = bands[band];
+        const auto n0 = c.b0 * c.b0 + c.b1 * c.b1 + c.b2 * c.b2;
+        const auto n1 = 2.0 * (c.b0 * c.b1 + c.b1 * c.b2);
+        const auto n2 = 2.0 * c.b0 * c.b2;
+        const auto d0 = 1.0 + c.a1 * c.a1 + c.a2 * c.a2;
+        const auto d1 = 2.0 * (c.a1 + c.a1 * c.a2);
+        const auto d2 = 2.0 * c.a2;
+        for (size_t k = 0; k < (size_t)numBins; ++k) {
+            const auto c1 = cosines[k];
+            const auto c2 = 2.0 * c1 * c1 - 1.0;
+            power[k] *= (n0 + n1 * c1 + n2 * c2) / (d0 + d1 * c1 + d2 * c2);
+        }
+    }
+
+    std::fill(fftData.begin(), fftData.end(), 0.0f);
+    for (size_t k = 0; k < (size_t)numBins; ++k)
+        fftData[2 * k] = (float)std::sqrt(juce::jmax(0.0, power[k]));
+    fft->performRealOnlyInverseTransform(fftData.data());
+
+    const int half = length / 2;
+    for (int n = 0; n < length; ++n)
+        kernel[(size_t)n] = window[(size_t)n] * fftData[(size_t)((n + half) & (length - 1))];
+}
+
+//off holds no memory, the next design sizes everything again
+void LinearPhaseBuilder::releaseScratch() {
+    fft.reset();
+    std::vector<double>().swap(cosines);
+    std::vector<double>().swap(power);
+    std::vector<float>().swap(window);
+    std::vector<float>().swap(fftData);
+    std::vector<float>().swap(kernel);
+}
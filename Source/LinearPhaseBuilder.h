@@ -0,0 +1,64 @@
+/*
+  ==============================================================================
+
+    LinearPhaseBuilder.h
+    Created: 16 Oct 2026 11:37:48am
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "FilterDesign.h"
+
+class ProceduralEqAudioProcessor;
+
+//==============================================================================
+/**
+*/
+//Background thread that turns the combined magnitude response of the active bands into
+//a linear phase FIR and posts it to the processor's convolver. The magnitude is sampled
+//from the designs the processor posted (makeCoefficients, so the filter design and
+//oversampling choices carry over), given zero phase, inverse transformed, centred and
+//windowed. The processor's timer calls update, which queues one build on the shared
+//builder thread when the kernel length or (with linear phase on) the bands have moved, so
+//a burst of band changes costs one rebuild and nothing runs while linear phase is off.
+//The build also sizes the processor's convolver for the length, and with linear phase off
+//neither holds any memory.
+class LinearPhaseBuilder : private juce::TimeSliceClient {
+public:
+    LinearPhaseBuilder(ProceduralEqAudioProcessor&, juce::TimeSliceThread&);
+    ~LinearPhaseBuilder() override;
+
+    //message thread, queues a build if the posted kernel is out of date
+    void update();
+
+    //designs a kernel for the current bands and posts it on the calling thread, false when
+    //linear phase is off or nothing was posted. That's when the bands are at different rates
+    //(a change of oversampling is halfway through), or when the convolver has to be resized
+    //and the audio thread hasn't let go of it yet; update queues it again either way. The
+    //shared thread runs this, prepareToPlay and the benchmark call it directly
+    bool build();
+
+    //held while the convolver is sized and a kernel is designed and posted, prepareToPlay
+    //takes it to free the convolver
+    juce::CriticalSection& getLock() { return lock; }
+
+private:
+    int useTimeSlice() override;
+    void design(int length, double sampleRate, double designRate, const BiquadCoeffs* bands, int numBands);
+    void releaseScratch();
+
+    ProceduralEqAudioProcessor& audioProcessor;
+    juce::TimeSliceThread& thread;
+    juce::CriticalSection lock;
+    std::atomic<uint32_t> builtGeneration{ 0 };   //what the last build saw
+    std::atomic<int> builtLength{ 0 };
+    std::unique_ptr<juce::dsp::FFT> fft;
+    std::vector<double> cosines;    //cos w of every bin at the design rate
+    std::vector<double> power;      //combined |H|^2 of every bin
+    std::vector<float> window;
+    std::vector<float> fftData;
+    std::vector<float> kernel;
+};
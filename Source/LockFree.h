@@ -0,0 +1,94 @@
+/*
+  ==============================================================================
+
+    LockFree.h
+    Created: 16 Oct 2026 11:20:05am
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+*/
+//Wait-free single producer/single consumer mailbox. The producer always writes
+//into a slot the consumer can't see, then swaps it in, so neither side ever
+//blocks and the consumer only ever sees whole values. Reads return false when
+//nothing new was posted since the last read.
+template <typename T>
+class TripleBuffer {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "TripleBuffer is meant for plain data");
+
+    void write(const T& value) noexcept {
+        slots[(size_t)back] = value;
+        back = middle.exchange(back | newDataBit, std::memory_order_acq_rel) & indexMask;
+    }
+
+    bool read(T& dest) noexcept {
+        if ((middle.load(std::memory_order_relaxed) & newDataBit) == 0)
+            return false;
+
+        front = middle.exchange(front, std::memory_order_acq_rel) & indexMask;
+        dest = slots[(size_t)front];
+        return true;
+    }
+
+    bool hasNewData() const noexcept {
+        return (middle.load(std::memory_order_relaxed) & newDataBit) != 0;
+    }
+
+private:
+    static constexpr int indexMask = 3;
+    static constexpr int newDataBit = 4;
+
+    std::array<T, 3> slots{};
+    std::atomic<int> middle{ 1 };
+    int back = 0;   //producer only
+    int front = 2;  //consumer only
+};
+
+//==============================================================================
+/**
+*/
+//Sequence lock around a plain value. There must only be one writer at a time
+//(callers serialise that themselves), the writer never waits, and readers retry
+//the copy if a write raced with it. Every completed write bumps the version, so
+//readers can also tell cheaply whether anything changed since they last looked.
+template <typename T>
+class SeqLock {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock is meant for plain data");
+
+    void write(const T& value) noexcept {
+        const auto seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&data, &value, sizeof(T));
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    //copies a consistent value into dest and returns its version
+    uint32_t read(T& dest) const noexcept {
+        for (;;) {
+            const auto before = sequence.load(std::memory_order_acquire);
+            if ((before & 1u) == 0) {
+                std::memcpy(&dest, &data, sizeof(T));
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (sequence.load(std::memory_order_relaxed) == before)
+                    return before >> 1;
+            }
+        }
+    }
+
+    uint32_t getVersion() const noexcept {
+        return sequence.load(std::memory_order_acquire) >> 1;
+    }
+
+private:
+    T data{};
+    std::atomic<uint32_t> sequence{ 0 };
+};
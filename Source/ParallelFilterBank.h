@@ -0,0 +1,103 @@
+/*
+  ==============================================================================
+
+    ParallelFilterBank.h
+    Created: 16 Oct 2026 6:10:44pm
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "FilterDesign.h"
+
+//==============================================================================
+/**
+*/
+//Runs the eq in parallel form, y = direct * x + sum of the branches, with the branches
+//packed into SIMD lanes so a register's worth of them (4 with SSE/NEON, 8 with AVX)
+//advance together. Branch i sits in lane i, so a band keeps its lane and its state when
+//the other bands change. Channels are run one after another, each with its own state.
+template <typename SampleType, int NumSections>
+class ParallelFilterBank {
+public:
+    using Register = juce::dsp::SIMDRegister<SampleType>;
+    static constexpr size_t lanes = Register::SIMDNumElements;
+    static constexpr size_t numRegisters = ((size_t)NumSections + lanes - 1) / lanes;
+
+    void prepare(const juce::dsp::ProcessSpec& spec) {
+        numChannels = (size_t)spec.numChannels;
+        state1.assign(numChannels * numRegisters, Register::expand(SampleType(0)));
+        state2.assign(numChannels * numRegisters, Register::expand(SampleType(0)));
+    }
+
+    void reset() {
+        std::fill(state1.begin(), state1.end(), Register::expand(SampleType(0)));
+        std::fill(state2.begin(), state2.end(), Register::expand(SampleType(0)));
+    }
+
+    //sections has NumSections entries, all zero ones for bands that are off
+    void setDesign(double directTerm, const ParallelSection* sections) {
+        direct = static_cast<SampleType>(directTerm);
+        for (size_t r = 0; r < numRegisters; ++r) {
+            alignas(32) SampleType c[4][lanes]{};
+            for (size_t l = 0; l < lanes; ++l) {
+                const auto i = r * lanes + l;
+                if (i < (size_t)NumSections) {
+                    c[0][l] = static_cast<SampleType>(sections[i].b0);
+                    c[1][l] = static_cast<SampleType>(sections[i].b1);
+                    c[2][l] = static_cast<SampleType>(sections[i].a1);
+                    c[3][l] = static_cast<SampleType>(-sections[i].a2);
+                }
+            }
+            b0[r] = Register::fromRawArray(c[0]);
+            b1[r] = Register::fromRawArray(c[1]);
+            a1[r] = Register::fromRawArray(c[2]);
+            negA2[r] = Register::fromRawArray(c[3]);
+        }
+    }
+
+    void process(const juce::dsp::ProcessContextReplacing<SampleType>& context,
+                 SampleType inputGain = SampleType(1), SampleType outputGain = SampleType(1)) {
+        auto& block = context.getOutputBlock();
+        const auto numSamples = block.getNumSamples();
+        jassert(block.getNumChannels() <= numChannels);
+
+        if (context.isBypassed || numSamples == 0)
+            return;
+
+        //the gains fold into the direct term and the branch input
+        const auto directGain = direct * inputGain * outputGain;
+        for (size_t ch = 0; ch < juce::jmin(numChannels, block.getNumChannels()); ++ch) {
+            auto* data = block.getChannelPointer(ch);
+            //local copies so the states can live in registers for the whole block
+            std::array<Register, numRegisters> z1, z2;
+            std::copy_n(state1.begin() + (std::ptrdiff_t)(ch * numRegisters), numRegisters, z1.begin());
+            std::copy_n(state2.begin() + (std::ptrdiff_t)(ch * numRegisters), numRegisters, z2.begin());
+
+            for (size_t i = 0; i < numSamples; ++i) {
+                const auto in = data[i];
+                const auto x = Register::expand(in * inputGain);
+                auto sum = Register::expand(SampleType(0));
+                for (size_t r = 0; r < numRegisters; ++r) {
+                    const auto y = b0[r] * x + z1[r];
+                    z1[r] = b1[r] * x - a1[r] * y + z2[r];
+                    z2[r] = negA2[r] * y;
+                    sum += y;
+                }
+                data[i] = directGain * in + sum.sum() * outputGain;
+            }
+            std::copy(z1.begin(), z1.end(), state1.begin() + (std::ptrdiff_t)(ch * numRegisters));
+            std::copy(z2.begin(), z2.end(), state2.begin() + (std::ptrdiff_t)(ch * numRegisters));
+        }
+    }
+
+private:
+    SampleType direct = SampleType(1);
+    std::array<Register, numRegisters> b0{}, b1{}, a1{}, negA2{};
+
+    //laid out [channel][register]
+    std::vector<Register> state1, state2;
+    size_t numChannels = 0;
+};
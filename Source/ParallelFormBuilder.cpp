@@ -0,0 +1,69 @@
+/*
+  ==============================================================================
+
+    ParallelFormBuilder.cpp
+    Created: 16 Oct 2026 6:14:32pm
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#include "ParallelFormBuilder.h"
+#include "PluginProcessor.h"
+
+ParallelFormBuilder::ParallelFormBuilder(ProceduralEqAudioProcessor& p, juce::TimeSliceThread& t) : audioProcessor(p), thread(t) {}
+
+ParallelFormBuilder::~ParallelFormBuilder() {
+    //waits for a build that's already running
+    thread.removeTimeSliceClient(this);
+}
+
+//nothing is built for the serial structure, the form is made fresh on the way back. A build
+//that's running is still on the thread's list, so this does nothing then, but if it read the
+//bands before the latest drain the next call finds it out of date and queues it again
+void ParallelFormBuilder::update() {
+    const bool parallel = audioProcessor.usesParallelStructure();
+    const bool switchedOver = parallel && !wasParallel;
+    wasParallel = parallel;
+    if (switchedOver || (parallel && builtGeneration.load() != audioProcessor.getDesignGeneration()))
+        thread.addTimeSliceClient(this);
+}
+
+//one build per wake up, then off the thread's list until update queues it again
+int ParallelFormBuilder::useTimeSlice() {
+    build();
+    return -1;
+}
+
+void ParallelFormBuilder::build() {
+    const juce::ScopedLock sl(lock);
+    //read before the bands, anything posted after this is built next time round
+    const auto generation = audioProcessor.getDesignGeneration();
+    builtGeneration = generation;
+
+    ParallelDesign design;
+    design.generation = generation;
+    std::array<BiquadCoeffs, MAX_EQS> active;
+    std::array<int, MAX_EQS> bandOf;
+    int numActive = 0;
+    for (int i = 0; i < MAX_EQS; ++i) {
+        BandDesign band;
+        audioProcessor.getGuiDesign(i, band);
+        if (!band.active)
+            continue;
+
+        //caught a drain halfway through a new rate, its generation brings us back
+        if (numActive > 0 && band.designRate != design.designRate)
+            return;
+        design.designRate = band.designRate;
+        active[(size_t)numActive] = band.coeffs;
+        bandOf[(size_t)numActive++] = i;
+    }
+
+    std::array<ParallelSection, MAX_EQS> sections;
+    design.valid = FilterDesign::makeParallelForm(active.data(), numActive, design.direct, sections.data());
+    if (design.valid)
+        for (int n = 0; n < numActive; ++n)
+            design.sections[(size_t)bandOf[(size_t)n]] = sections[(size_t)n];
+    audioProcessor.setParallelDesign(design);
+}
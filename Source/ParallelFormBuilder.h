@@ -0,0 +1,46 @@
+/*
+  ==============================================================================
+
+    ParallelFormBuilder.h
+    Created: 16 Oct 2026 6:14:32pm
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+class ProceduralEqAudioProcessor;
+
+//==============================================================================
+/**
+*/
+//Rewrites the posted band designs as one parallel form and posts it to the processor. Any
+//band change moves every residue, so the whole form is rebuilt, but only while the parallel
+//structure is selected: the processor's timer calls update, which queues one build on the
+//shared builder thread on switching over and then one per batch of band changes. Nothing
+//runs while serial, and neither the audio thread nor parameterChanged ever builds a form.
+class ParallelFormBuilder : private juce::TimeSliceClient {
+public:
+    ParallelFormBuilder(ProceduralEqAudioProcessor&, juce::TimeSliceThread&);
+    ~ParallelFormBuilder() override;
+
+    //message thread, queues a build if the form is out of date for the parallel structure
+    void update();
+
+    //builds a form from the current bands and posts it on the calling thread, whatever the
+    //structure. Nothing is posted while the bands are at different rates, a change of
+    //oversampling is then halfway through. The shared thread runs this, prepareToPlay calls
+    //it so a render starts parallel
+    void build();
+
+private:
+    int useTimeSlice() override;
+
+    ProceduralEqAudioProcessor& audioProcessor;
+    juce::TimeSliceThread& thread;
+    juce::CriticalSection lock;
+    std::atomic<uint32_t> builtGeneration{ 0 };   //what the last build saw
+    bool wasParallel = false;   //message thread only
+};
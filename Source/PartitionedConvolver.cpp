@@ -0,0 +1,168 @@
+/*
+  ==============================================================================
+
+    PartitionedConvolver.cpp
+    Created: 16 Oct 2026 10:52:19am
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#include "PartitionedConvolver.h"
+
+void PartitionedConvolver::prepare(const juce::dsp::ProcessSpec& spec, int newPartitionSize, int maxKernelLength) {
+    jassert(juce::isPowerOfTwo(newPartitionSize) && maxKernelLength > 0);
+    partitionSize = newPartitionSize;
+    numBins = partitionSize + 1;
+    maxPartitions = (maxKernelLength + partitionSize - 1) / partitionSize;
+    numChannels = (size_t)spec.numChannels;
+
+    //the FFTs are twice the partition, juce's real-only transforms want twice their size in floats
+    const int order = juce::roundToInt(std::log2(2 * partitionSize));
+    fft = std::make_unique<juce::dsp::FFT>(order);
+    kernelFFT = std::make_unique<juce::dsp::FFT>(order);
+    fftData.assign(4 * (size_t)partitionSize, 0.0f);
+    kernelFFTData.assign(4 * (size_t)partitionSize, 0.0f);
+
+    inputs.assign(numChannels * 2 * (size_t)partitionSize, 0.0f);
+    outputs.assign(numChannels * (size_t)partitionSize, 0.0f);
+    delayRe.assign(numChannels * (size_t)maxPartitions * (size_t)numBins, 0.0f);
+    delayIm.assign(numChannels * (size_t)maxPartitions * (size_t)numBins, 0.0f);
+    accRe.assign((size_t)numBins, 0.0f);
+    accIm.assign((size_t)numBins, 0.0f);
+    fadeScratch.assign((size_t)partitionSize, 0.0f);
+
+    for (auto& kernel : kernels) {
+        kernel.re.assign((size_t)maxPartitions * (size_t)numBins, 0.0f);
+        kernel.im.assign((size_t)maxPartitions * (size_t)numBins, 0.0f);
+        kernel.numPartitions = 0;
+    }
+    newest = 1;
+    writing = 0;
+    current = 2;
+    previous = 3;
+    reset();
+}
+
+void PartitionedConvolver::release() {
+    partitionSize = 0;
+    numBins = 0;
+    maxPartitions = 0;
+    numChannels = 0;
+    fft.reset();
+    kernelFFT.reset();
+    //swapped with empty ones, clear() keeps the capacity
+    for (auto* buffer : { &fftData, &kernelFFTData, &inputs, &outputs, &delayRe, &delayIm, &accRe, &accIm, &fadeScratch })
+        std::vector<float>().swap(*buffer);
+    for (auto& kernel : kernels) {
+        std::vector<float>().swap(kernel.re);
+        std::vector<float>().swap(kernel.im);
+        kernel.numPartitions = 0;
+    }
+    position = 0;
+    head = 0;
+}
+
+void PartitionedConvolver::reset() {
+    std::fill(inputs.begin(), inputs.end(), 0.0f);
+    std::fill(outputs.begin(), outputs.end(), 0.0f);
+    std::fill(delayRe.begin(), delayRe.end(), 0.0f);
+    std::fill(delayIm.begin(), delayIm.end(), 0.0f);
+    position = 0;
+    head = 0;
+    takeNewestKernel();
+}
+
+bool PartitionedConvolver::setKernel(const float* kernel, int length) {
+    if (partitionSize == 0 || length <= 0 || length > maxPartitions * partitionSize)
+        return false;
+
+    auto& dest = kernels[(size_t)writing];
+    dest.numPartitions = (length + partitionSize - 1) / partitionSize;
+    for (int p = 0; p < dest.numPartitions; ++p) {
+        //each partition zero padded to the FFT size, which is what makes overlap-save work
+        const int num = juce::jmin(partitionSize, length - p * partitionSize);
+        std::fill(kernelFFTData.begin(), kernelFFTData.end(), 0.0f);
+        std::copy_n(kernel + p * partitionSize, num, kernelFFTData.begin());
+        kernelFFT->performRealOnlyForwardTransform(kernelFFTData.data(), true);
+
+        auto* re = dest.re.data() + (size_t)p * (size_t)numBins;
+        auto* im = dest.im.data() + (size_t)p * (size_t)numBins;
+        for (int k = 0; k < numBins; ++k) {
+            re[k] = kernelFFTData[2 * (size_t)k];
+            im[k] = kernelFFTData[2 * (size_t)k + 1];
+        }
+    }
+
+    writing = newest.exchange(writing | newKernelBit, std::memory_order_acq_rel) & indexMask;
+    return true;
+}
+
+//the running kernel becomes previous, the slot previous held goes back to setKernel
+bool PartitionedConvolver::takeNewestKernel() {
+    if ((newest.load(std::memory_order_relaxed) & newKernelBit) == 0)
+        return false;
+
+    const int taken = newest.exchange(previous, std::memory_order_acq_rel) & indexMask;
+    previous = current;
+    current = taken;
+    return true;
+}
+
+void PartitionedConvolver::processPartition() {
+    //a kernel posted since the last partition is faded in across this one
+    const bool fading = takeNewestKernel() && kernels[(size_t)previous].numPartitions > 0;
+    head = head + 1 < maxPartitions ? head + 1 : 0;
+
+    for (size_t ch = 0; ch < numChannels; ++ch) {
+        auto* in = getInput(ch);
+        std::copy_n(in, 2 * partitionSize, fftData.begin());
+        fft->performRealOnlyForwardTransform(fftData.data(), true);
+
+        const auto offset = (ch * (size_t)maxPartitions + (size_t)head) * (size_t)numBins;
+        for (int k = 0; k < numBins; ++k) {
+            delayRe[offset + (size_t)k] = fftData[2 * (size_t)k];
+            delayIm[offset + (size_t)k] = fftData[2 * (size_t)k + 1];
+        }
+        //the partition just taken in is the first half of the next window
+        std::copy_n(in + partitionSize, partitionSize, in);
+
+        auto* out = getOutput(ch);
+        convolve(kernels[(size_t)current], ch, out);
+        if (fading) {
+            convolve(kernels[(size_t)previous], ch, fadeScratch.data());
+            const auto step = 1.0f / (float)partitionSize;
+            for (int i = 0; i < partitionSize; ++i)
+                out[i] = fadeScratch[(size_t)i] + (out[i] - fadeScratch[(size_t)i]) * ((float)i + 1.0f) * step;
+        }
+    }
+}
+
+//sums every kernel partition against the input spectrum it lines up with, then takes the
+//last partitionSize samples of the inverse, the first half wraps around and is thrown away
+void PartitionedConvolver::convolve(const Kernel& kernel, size_t channel, float* dest) {
+    std::fill(accRe.begin(), accRe.end(), 0.0f);
+    std::fill(accIm.begin(), accIm.end(), 0.0f);
+    auto* __restrict sumRe = accRe.data();
+    auto* __restrict sumIm = accIm.data();
+
+    for (int p = 0; p < kernel.numPartitions; ++p) {
+        const int slot = head - p >= 0 ? head - p : head - p + maxPartitions;
+        const auto offset = (channel * (size_t)maxPartitions + (size_t)slot) * (size_t)numBins;
+        const auto* xRe = delayRe.data() + offset;
+        const auto* xIm = delayIm.data() + offset;
+        const auto* hRe = kernel.re.data() + (size_t)p * (size_t)numBins;
+        const auto* hIm = kernel.im.data() + (size_t)p * (size_t)numBins;
+        for (int k = 0; k < numBins; ++k) {
+            sumRe[k] += xRe[k] * hRe[k] - xIm[k] * hIm[k];
+            sumIm[k] += xRe[k] * hIm[k] + xIm[k] * hRe[k];
+        }
+    }
+
+    for (int k = 0; k < numBins; ++k) {
+        fftData[2 * (size_t)k] = sumRe[k];
+        fftData[2 * (size_t)k + 1] = sumIm[k];
+    }
+    fft->performRealOnlyInverseTransform(fftData.data());
+    std::copy_n(fftData.begin() + partitionSize, partitionSize, dest);
+}
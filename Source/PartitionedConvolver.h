@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    PartitionedConvolver.h
+    Created: 16 Oct 2026 10:52:19am
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+
+//==============================================================================
+/**
+*/
+//Uniformly partitioned overlap-save convolution, runs the linear phase kernel. The kernel
+//is cut into partitionSize long pieces that are transformed once when it's posted, and the
+//input is transformed once per partition into a frequency domain delay line. A partition
+//of output then costs one forward and one inverse FFT per channel plus a complex multiply
+//add per kernel partition, and comes out one partition late.
+//Kernels are posted from a background thread with setKernel, which does their FFTs on that
+//thread. The audio thread picks up the newest one at the next partition boundary and fades
+//over from the old one across that partition. Both run off the same delay line, so the
+//swap doesn't click. Everything is sized in prepare for the longest kernel it'll be given,
+//so posting and processing never allocate, and release gives it all back. The FFTs are
+//float, double buffers are narrowed on the way in.
+class PartitionedConvolver {
+public:
+    //not while setKernel runs, whoever posts kernels has to hold them off
+    void prepare(const juce::dsp::ProcessSpec& spec, int partitionSize, int maxKernelLength);
+    //frees everything prepare allocated, nothing runs until it's prepared again. Same rules
+    void release();
+    //clears the history and switches straight to the newest kernel, audio thread only
+    void reset();
+
+    //one thread at a time, never the audio thread. False if the convolver isn't prepared
+    //or the kernel is longer than it was prepared for
+    bool setKernel(const float* kernel, int length);
+
+    int getLatency() const { return partitionSize; }
+    //longest kernel setKernel takes, 0 when it isn't prepared
+    int getMaxKernelLength() const { return maxPartitions * partitionSize; }
+
+    //inputGain and outputGain ride along with the copies in and out of the partition buffers
+    template <typename SampleType>
+    void process(const juce::dsp::ProcessContextReplacing<SampleType>& context,
+                 SampleType inputGain = SampleType(1), SampleType outputGain = SampleType(1)) {
+        auto& block = context.getOutputBlock();
+        const auto channels = juce::jmin(numChannels, block.getNumChannels());
+        const auto numSamples = (int)block.getNumSamples();
+        jassert(partitionSize > 0); //prepare() first
+
+        if (context.isBypassed || numSamples == 0 || partitionSize == 0)
+            return;
+
+        for (int done = 0; done < numSamples;) {
+            const int num = juce::jmin(partitionSize - position, numSamples - done);
+            for (size_t ch = 0; ch < channels; ++ch) {
+                auto* data = block.getChannelPointer(ch) + done;
+                auto* in = getInput(ch) + partitionSize + position;
+                const auto* out = getOutput(ch) + position;
+                for (int i = 0; i < num; ++i) {
+                    in[i] = static_cast<float>(data[i] * inputGain);
+                    data[i] = static_cast<SampleType>(out[i]) * outputGain;
+                }
+            }
+
+            position += num;
+            done += num;
+            if (position == partitionSize) {
+                processPartition();
+                position = 0;
+            }
+        }
+    }
+
+private:
+    //spectra of a kernel's partitions laid out [partition][bin], real and imaginary parts
+    //split so the multiply-adds vectorise
+    struct Kernel {
+        std::vector<float> re, im;
+        int numPartitions = 0;
+    };
+
+    void processPartition();
+    void convolve(const Kernel& kernel, size_t channel, float* dest);
+    bool takeNewestKernel();
+    float* getInput(size_t channel) { return inputs.data() + channel * 2 * (size_t)partitionSize; }
+    float* getOutput(size_t channel) { return outputs.data() + channel * (size_t)partitionSize; }
+
+    int partitionSize = 0;
+    int numBins = 0;    //partitionSize + 1, the non-negative half of a 2 * partitionSize FFT
+    int maxPartitions = 0;
+    size_t numChannels = 0;
+    std::unique_ptr<juce::dsp::FFT> fft, kernelFFT;     //audio thread's and setKernel's
+    std::vector<float> fftData, kernelFFTData;
+
+    //per channel: the last partition of input then the one being filled, the output being
+    //played out, and the delay line of input spectra laid out [partition][bin]
+    std::vector<float> inputs, outputs;
+    std::vector<float> delayRe, delayIm;
+    std::vector<float> accRe, accIm;
+    std::vector<float> fadeScratch;
+    int position = 0;
+    int head = 0;   //newest spectrum in the delay line
+
+    //TripleBuffer's scheme on slot indices, with a fourth slot the audio thread keeps the
+    //old kernel in while it fades out
+    static constexpr int indexMask = 3;
+    static constexpr int newKernelBit = 4;
+    std::array<Kernel, 4> kernels;
+    std::atomic<int> newest{ 1 };
+    int writing = 0;    //setKernel only
+    int current = 2;    //audio thread only
+    int previous = 3;   //audio thread only
+};
@@ -64,72 +64,41 @@ void GainComponent::resized() {
 //==============================================================================
 /**
 */
-SpectrumAnalyser::SpectrumAnalyser(ProceduralEqAudioProcessor& p, ProceduralEqAudioProcessorEditor& e) : audioProcessor(p), editor(e), 
-                                   forwardFFT(fftOrder), window(fftSize, juce::dsp::WindowingFunction<float>::hann) {
+SpectrumAnalyser::SpectrumAnalyser(ProceduralEqAudioProcessor& p, ProceduralEqAudioProcessorEditor& e) : audioProcessor(p), editor(e), worker(p) {
     setInterceptsMouseClicks(false, false);
     setOpaque(false);
     lineColor = juce::Colours::lime;
-    startTimerHz(TIMER_FPS);
 }
 
 SpectrumAnalyser::~SpectrumAnalyser() {}
 
-void SpectrumAnalyser::timerCallback() {
-    auto* fifo = audioProcessor.getAnalyserFifo();
-    if (!fifo)
-        return;
-
-    float temp[fftSize];
-    const int numRead = fifo->pop(temp, fftSize);
-
-    if (numRead > 0) {
-        juce::zeromem(fftData, sizeof(fftData));
-
-        // Only copy the actual data we received
-        int samplesToCopy = juce::jmin(numRead, static_cast<int>(fftSize));
-        std::copy(temp, temp + samplesToCopy, fftData);
-
-        // Zero-pad if we didn't get enough samples
-        if (samplesToCopy < fftSize) {
-            std::fill(fftData + samplesToCopy, fftData + fftSize, 0.0f);
-        }
-        window.multiplyWithWindowingTable(fftData, fftSize);
-        forwardFFT.performFrequencyOnlyForwardTransform(fftData);
-
-        drawNextFrameOfSpectrum();
+void SpectrumAnalyser::updateFromWorker() {
+    //the fft runs on the worker, all that's left here is picking up its latest frame
+    if (worker.getLatestFrame(scopeData))
         repaint();
-    }
-}
-
-void SpectrumAnalyser::drawNextFrameOfSpectrum() {
-    auto mindB = -100.0f;
-    auto maxdB = 24.0f;
-    for (int i = 0; i < scopeSize; ++i) {
-        auto skewedProportionX = 1.0f - std::exp(std::log(1.0 - (double)i / (double)scopeSize) * 0.2);
-        auto fftIndex = juce::jlimit(0, fftSize / 2, (int)(skewedProportionX * (double)(fftSize / 2)));
-
-        auto level = juce::jmap(juce::Decibels::gainToDecibels(fftData[fftIndex])
-            - maxdB,
-            mindB, maxdB, 0.0f, 1.0f);
-
-        scopeData[i] = juce::jlimit(0.0f, 1.0f, level);
-    }
 }
 
 void SpectrumAnalyser::paint(juce::Graphics& g) {
-    g.setColour(lineColor);
     auto w = (float)getWidth();
     auto h = (float)getHeight();
-
-    juce::Path p;
     auto mapY = [h](float v) { return juce::jmap(v, 0.0f, 1.0f, h, 0.0f); };
 
-    p.startNewSubPath(0.0f, mapY(scopeData[0]));
-    for (int i = 1; i < scopeSize; ++i)
-        p.lineTo(juce::jmap((float)i, 0.0f, (float)scopeSize - 1.0f, 0.0f, w),
-            mapY(scopeData[i]));
-    juce::Path rounded = p.createPathWithRoundedCorners(16.0f);
-    g.strokePath(rounded, juce::PathStrokeType(2.0f));
+    auto makePath = [&](const ScopeFrame& data) {
+        juce::Path p;
+        p.startNewSubPath(0.0f, mapY(data[0]));
+        for (int i = 1; i < scopeSize; ++i)
+            p.lineTo(juce::jmap((float)i, 0.0f, (float)scopeSize - 1.0f, 0.0f, w),
+                mapY(data[(size_t)i]));
+        return p.createPathWithRoundedCorners(16.0f);
+    };
+
+    if (scopeData.hasPeak) {
+        g.setColour(lineColor.withAlpha(0.4f));
+        g.strokePath(makePath(scopeData.peak), juce::PathStrokeType(1.0f));
+    }
+
+    g.setColour(lineColor);
+    g.strokePath(makePath(scopeData.level), juce::PathStrokeType(2.0f));
 }
 
 //==============================================================================
@@ -174,6 +143,11 @@ SelectedEqComponent::SelectedEqComponent(ProceduralEqAudioProcessor& p, int id)
     typeComboBox.addItem("HIGH-SHELF", 4);
     typeComboBox.addItem("LOW-SHELF", 5);
     typeBoxAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.tree, params[3 + currEq * 6], typeComboBox);
+    addAndMakeVisible(engineComboBox);
+    engineComboBox.addItem("BIQUAD", 1);
+    engineComboBox.addItem("SVF", 2);
+    engineComboBox.setTooltip("SVF keeps the same response but takes fast modulation without transients");
+    engineBoxAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.tree, engineParams[currEq], engineComboBox);
     addAndMakeVisible(typeLabel);
     typeLabel.setText("TYPE", juce::NotificationType::dontSendNotification);
     typeLabel.setJustificationType(juce::Justification::centred);
@@ -210,6 +184,7 @@ void SelectedEqComponent::updateEqAndSliders(int id) {
     gainSliderAttachment.reset();
     qualitySliderAttachment.reset();
     typeBoxAttachment.reset();
+    engineBoxAttachment.reset();
     bypassButtonAttachment.reset();
     //set new eq and attach all params to sliders
     currEq = id;
@@ -217,6 +192,7 @@ void SelectedEqComponent::updateEqAndSliders(int id) {
     gainSliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.tree, params[1 + currEq * 6], gainSlider);
     qualitySliderAttachment = std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(audioProcessor.tree, params[2 + currEq * 6], qualitySlider);
     typeBoxAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.tree, params[3 + currEq * 6], typeComboBox);
+    engineBoxAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(audioProcessor.tree, engineParams[currEq], engineComboBox);
     bypassButtonAttachment = std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(audioProcessor.tree, params[4 + currEq * 6], bypassButton);
     deleteButton.setToggleState(false, juce::NotificationType::dontSendNotification);
 }
@@ -247,7 +223,9 @@ void SelectedEqComponent::resized() {
 
     auto tArea = bounds.removeFromLeft(w);
     typeLabel.setBounds(tArea.removeFromTop(labelHeight));
-    typeComboBox.setBounds(tArea.reduced(10));
+    tArea.reduce(10, 5);
+    typeComboBox.setBounds(tArea.removeFromTop(tArea.getHeight() / 2).reduced(0, 2));
+    engineComboBox.setBounds(tArea.reduced(0, 2));
 
     auto dArea = bounds.removeFromRight(w);
     deleteLabel.setBounds(dArea.removeFromTop(labelHeight));
@@ -262,13 +240,23 @@ void SelectedEqComponent::resized() {
 */
 ResponseCurveComponent::ResponseCurveComponent(ProceduralEqAudioProcessor& p, ProceduralEqAudioProcessorEditor& e) : audioProcessor(p), editor(e) {
     setInterceptsMouseClicks(false, false);
-    for (int i = 0; i < params.size(); ++i)
-        audioProcessor.tree.addParameterListener(params[i], this);
 }
 
-ResponseCurveComponent::~ResponseCurveComponent() {
-    for (int i = 0; i < params.size(); ++i)
-        audioProcessor.tree.removeParameterListener(params[i], this);
+ResponseCurveComponent::~ResponseCurveComponent() {}
+
+//true when a band was redesigned (or the rate changed) since the curve was last built
+bool ResponseCurveComponent::isOutOfDate() const {
+    if (getSampleRateForDisplay() != evaluator.getSampleRate())
+        return true;
+    for (int j = 0; j < MAX_EQS; ++j)
+        if (audioProcessor.getGuiVersion(j) != seenVersions[j])
+            return true;
+    return false;
+}
+
+double ResponseCurveComponent::getSampleRateForDisplay() const {
+    auto sampleRate = audioProcessor.getDesignSampleRate();
+    return sampleRate > 0.0 ? sampleRate : 44100.0;
 }
 
 void ResponseCurveComponent::paint(juce::Graphics& g) {
@@ -278,26 +266,7 @@ void ResponseCurveComponent::paint(juce::Graphics& g) {
     const int w = responseArea.getWidth();
     if (w <= 0)
         return;
-    auto sampleRate = audioProcessor.getSampleRate();
-    if (sampleRate <= 0.0)
-        sampleRate = 44100.0;
-
-    std::vector<double> mags;
-    mags.resize(w);
-
-    for (int i = 0; i < w; ++i) {
-        double mag = 1.0f;
-        double frac = double(i) / double(w - 1);
-        auto freq = mapToLog10(frac, 20.0, 20000.0);
-        for (int j = 0; j < MAX_EQS; ++j) {
-            const auto& req = audioProcessor.getPendingUpdates()[j];
-            if (req.isInit && !req.bypass) {
-                auto coeffs = audioProcessor.guiCoeffs[j];
-                mag *= coeffs.getMagnitudeForFrequency(freq, sampleRate);
-            }
-        }
-        mags[i] = Decibels::gainToDecibels(mag);
-    }
+    updateResponse(w, getSampleRateForDisplay());
 
     Path responseCurve;
 
@@ -319,8 +288,35 @@ void ResponseCurveComponent::paint(juce::Graphics& g) {
     g.strokePath(responseCurve, PathStrokeType(2.0f));
 }
 
-void ResponseCurveComponent::parameterChanged(const juce::String& paramID, float newValue) {
-    repaint();
+//Every band keeps its own dB curve per pixel column. Only bands whose snapshot version
+//moved get re-evaluated (all of them if the width or sample rate changed), and the
+//drawn curve is the sum of the cached arrays
+void ResponseCurveComponent::updateResponse(int w, double sampleRate) {
+    const bool gridChanged = evaluator.prepare(w, 20.0, 20000.0, sampleRate);
+    if (gridChanged) {
+        for (auto& db : bandDb)
+            db.assign((size_t)w, 0.0f);
+    }
+
+    bool anyChanged = gridChanged;
+    for (int j = 0; j < MAX_EQS; ++j) {
+        if (!gridChanged && audioProcessor.getGuiVersion(j) == seenVersions[j])
+            continue;
+
+        BandDesign design;
+        seenVersions[j] = audioProcessor.getGuiDesign(j, design);
+        bandActive[j] = design.active;
+        if (design.active)
+            evaluator.evaluate(design.coeffs, bandDb[j].data());
+        anyChanged = true;
+    }
+
+    if (anyChanged) {
+        mags.assign((size_t)w, 0.0f);
+        for (int j = 0; j < MAX_EQS; ++j)
+            if (bandActive[j])
+                juce::FloatVectorOperations::add(mags.data(), bandDb[j].data(), w);
+    }
 }
 
 //==============================================================================
@@ -329,15 +325,9 @@ void ResponseCurveComponent::parameterChanged(const juce::String& paramID, float
 DraggableButton::DraggableButton(ProceduralEqAudioProcessor& p, ProceduralEqAudioProcessorEditor& e, int eqId) :
                                  Button(juce::String()), audioProcessor(p), editor(e), associatedEq(eqId), circleColour(colours[eqId]) {
     setSize(20, 20);
-    audioProcessor.tree.addParameterListener(params[0 + eqId * 6], this); //freq
-    audioProcessor.tree.addParameterListener(params[1 + eqId * 6], this); //gain
-    audioProcessor.tree.addParameterListener(params[4 + eqId * 6], this); //bypass
 }
 
 DraggableButton::~DraggableButton() {
-    audioProcessor.tree.removeParameterListener(params[0 + associatedEq * 6], this);
-    audioProcessor.tree.removeParameterListener(params[1 + associatedEq * 6], this);
-    audioProcessor.tree.removeParameterListener(params[4 + associatedEq * 6], this);
 }
 
 void DraggableButton::paintButton(juce::Graphics& g, bool shouldDrawButtonAsHighlighted, bool shouldDrawButtonAsDown) {
@@ -406,13 +396,12 @@ bool DraggableButton::hitTest(int x, int y) {
     return centre.getDistanceFrom({ x, y }) <= radius;
 }
 
-void DraggableButton::parameterChanged(const juce::String& paramID, float newValue) {
+//called by the editor's pump when any of this band's params moved
+void DraggableButton::updateFromProcessor() {
     const auto& req = audioProcessor.getUpdateForBand(associatedEq);
-    if (paramID == params[0 + associatedEq * 6])
-        setCentreFromFreq(req.freq);
-    else if (paramID == params[1 + associatedEq * 6])
-        setCentreFromGain(req.gain);
-    else if (paramID == params[4 + associatedEq * 6]) {
+    setCentreFromFreq(req.freq);
+    setCentreFromGain(req.gain);
+    if (isBypassed != req.bypass) {
         isBypassed = req.bypass;
         repaint();
     }
@@ -435,6 +424,17 @@ void DraggableButton::updateTooltip() {
     const auto& req = audioProcessor.getUpdateForBand(associatedEq);
     juce::String tip;
     tip << formatFrequency(req.freq) << ", " << formatGain(req.gain);
+
+    //group delay of this band at its own frequency
+    BandDesign design;
+    audioProcessor.getGuiDesign(associatedEq, design);
+    auto sampleRate = audioProcessor.getDesignSampleRate();
+    if (design.active && sampleRate > 0.0) {
+        float delay = 0.0f;
+        pointEvaluator.prepare(1, req.freq, req.freq, sampleRate);
+        pointEvaluator.evaluate(design.coeffs, nullptr, nullptr, &delay);
+        tip << ", " << juce::String(1000.0 * delay / sampleRate, 2) << " ms";
+    }
     setTooltip(tip);
 }
 
@@ -444,7 +444,7 @@ void DraggableButton::updateTooltip() {
 */
 ProceduralEqAudioProcessorEditor::ProceduralEqAudioProcessorEditor(ProceduralEqAudioProcessor& p)
     : AudioProcessorEditor(&p), audioProcessor(p), selectedEqComponent(audioProcessor, 0), rcc(audioProcessor, *this), 
-      analyser(audioProcessor, *this), gainComponent(audioProcessor) {
+      analyser(audioProcessor, *this), gainComponent(audioProcessor), vblank(this, [this] { updateFromProcessor(); }) {
     setSize(1200, 675);
     buttonBounds = backgroundImage();
     auto area = getRenderArea();
@@ -495,6 +495,31 @@ ProceduralEqAudioProcessorEditor::ProceduralEqAudioProcessorEditor(ProceduralEqA
 
     analyser.setVisible(analyserOnButton.getToggleState());
     analyser.lineColor = analyserModeButton.getToggleState() ? juce::Colours::lime : juce::Colours::yellow;
+
+    for (int i = 0; i < MAX_EQS; ++i)
+        seenBandVersions[i] = audioProcessor.getBandVersion(i);
+}
+
+//Runs once per display refresh. Parameter changes only bump counters in the processor, so
+//however many automation events land between two frames each component is invalidated at
+//most once, and only if its own data moved
+void ProceduralEqAudioProcessorEditor::updateFromProcessor() {
+    //the processor's timer drains too, this keeps the curve in step with the display
+    audioProcessor.drainDirtyBands();
+
+    for (int i = 0; i < MAX_EQS; ++i) {
+        const auto version = audioProcessor.getBandVersion(i);
+        if (version != seenBandVersions[i]) {
+            seenBandVersions[i] = version;
+            buttonArr[i]->updateFromProcessor();
+        }
+    }
+
+    if (rcc.isOutOfDate())
+        rcc.repaint();
+
+    if (analyser.isVisible())
+        analyser.updateFromWorker();
 }
 
 ProceduralEqAudioProcessorEditor::~ProceduralEqAudioProcessorEditor() {
@@ -531,9 +556,6 @@ void ProceduralEqAudioProcessorEditor::mouseDoubleClick(const juce::MouseEvent&
             audioProcessor.updateParameter(i, 5, 1);
             audioProcessor.updateParameter(i, 4, 0);
 
-            const auto& req = audioProcessor.getUpdateForBand(i);
-            audioProcessor.guiCoeffs[i] = audioProcessor.makeCoefficients(req);
-
             setSelectedEq(i);
             buttonArr[i]->setVisible(true);
             return;
@@ -11,20 +11,15 @@
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
 #include "CustomLookAndFeel.h"
+#include "SpectrumAnalysis.h"
+#include "ResponseEvaluator.h"
 
 //==============================================================================
 /**
 */
 class ProceduralEqAudioProcessorEditor;
 
-enum {
-    fftOrder = 11,
-    fftSize = 1 << fftOrder,
-    scopeSize = 512
-};
-
 constexpr int TOOLTIP_DELAY = 200;  //milliseconds
-constexpr int TIMER_FPS = 30;       //hz
 
 static auto makeSquareForSlider(juce::Rectangle<int> area) {
     auto knobArea = area.removeFromTop(area.getHeight() - 15);
@@ -54,24 +49,21 @@ private:
 //==============================================================================
 /**
 */
-struct SpectrumAnalyser : juce::Component, juce::Timer {
+struct SpectrumAnalyser : juce::Component {
     SpectrumAnalyser(ProceduralEqAudioProcessor&, ProceduralEqAudioProcessorEditor&);
     ~SpectrumAnalyser();
 
-    void timerCallback() override;
+    void updateFromWorker();
     void paint(juce::Graphics& g) override;
-    void drawNextFrameOfSpectrum();
 
     juce::Colour lineColor;
 
 private:
     ProceduralEqAudioProcessor& audioProcessor;
     ProceduralEqAudioProcessorEditor& editor;
-    juce::dsp::FFT forwardFFT;
-    juce::dsp::WindowingFunction<float> window;
+    SpectrumWorker worker;
 
-    float fftData[2 * fftSize]{};
-    float scopeData[scopeSize]{};
+    AnalyserFrame scopeData;
 };
 
 //==============================================================================
@@ -96,11 +88,11 @@ private:
     int textboxHeight = 15;
     int currEq;
     juce::Slider freqSlider, gainSlider, qualitySlider;
-    juce::ComboBox typeComboBox;
+    juce::ComboBox typeComboBox, engineComboBox;
     juce::ToggleButton bypassButton;
     juce::TextButton deleteButton;
     std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment> freqSliderAttachment, gainSliderAttachment, qualitySliderAttachment;
-    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> typeBoxAttachment;
+    std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment> typeBoxAttachment, engineBoxAttachment;
     std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment> bypassButtonAttachment;
     juce::Label freqLabel, gainLabel, qualityLabel, typeLabel, bypassLabel, deleteLabel;
     CustomLookAndFeelB lnfb;
@@ -109,23 +101,31 @@ private:
 //==============================================================================
 /**
 */
-struct ResponseCurveComponent : juce::Component, private juce::AudioProcessorValueTreeState::Listener {
+struct ResponseCurveComponent : juce::Component {
     ResponseCurveComponent(ProceduralEqAudioProcessor&, ProceduralEqAudioProcessorEditor&);
     ~ResponseCurveComponent();
 
     void paint(juce::Graphics& g) override;
+    bool isOutOfDate() const;
 
 private:
-    void parameterChanged(const juce::String& paramID, float newValue) override;
+    double getSampleRateForDisplay() const;
+    void updateResponse(int w, double sampleRate);
 
     ProceduralEqAudioProcessor& audioProcessor;
     ProceduralEqAudioProcessorEditor& editor;
+
+    ResponseEvaluator evaluator;
+    std::array<std::vector<float>, MAX_EQS> bandDb;
+    std::array<bool, MAX_EQS> bandActive{};
+    std::vector<float> mags;
+    std::array<uint32_t, MAX_EQS> seenVersions{};
 };
 
 //==============================================================================
 /**
 */
-struct DraggableButton : juce::Button, private juce::AudioProcessorValueTreeState::Listener {
+struct DraggableButton : juce::Button {
     DraggableButton(ProceduralEqAudioProcessor&, ProceduralEqAudioProcessorEditor&, int eqId);
     ~DraggableButton();
 
@@ -136,9 +136,9 @@ struct DraggableButton : juce::Button, private juce::AudioProcessorValueTreeStat
     void updateParamsFromPosition();
     void updatePositionFromParams();
     void updateTooltip();
+    void updateFromProcessor();
 
 private:
-    void parameterChanged(const juce::String& paramID, float newValue) override;
     void setCentreFromFreq(float freq);
     void setCentreFromGain(float gain);
 
@@ -147,6 +147,7 @@ private:
     juce::Colour circleColour;
     int associatedEq;
     juce::ComponentDragger dragger;
+    ResponseEvaluator pointEvaluator;
     bool isBypassed = false;
 };
 
@@ -173,6 +174,8 @@ public:
     void buttonReset(int id);
 
 private:
+    void updateFromProcessor();
+
     ProceduralEqAudioProcessor& audioProcessor;
     SpectrumAnalyser analyser;
     ResponseCurveComponent rcc;
@@ -191,5 +194,9 @@ private:
     CustomLookAndFeelA lnfa;
     CustomLookAndFeelC lnfc;
 
+    //one pump per display refresh instead of listeners and timers in every component
+    std::array<uint32_t, MAX_EQS> seenBandVersions{};
+    juce::VBlankAttachment vblank;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProceduralEqAudioProcessorEditor)
 };
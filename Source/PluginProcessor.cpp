@@ -26,6 +26,12 @@ juce::StringArray params{ "1Freq", "1Gain", "1Quality", "1Type", "1Bypass", "1In
 
 juce::StringArray bands{ "BANDPASS", "HIGHPASS", "LOWPASS", "HIGHSHELF", "LOWSHELF" };
 
+//per band filter engine, kept out of params so the band * 6 indexing above stays as it is
+juce::StringArray engineParams{ "1Engine", "2Engine", "3Engine", "4Engine", "5Engine", "6Engine",
+                                "7Engine", "8Engine", "9Engine", "10Engine", "11Engine", "12Engine" };
+
+juce::StringArray engines{ "BIQUAD", "SVF" };
+
 //==============================================================================
 ProceduralEqAudioProcessor::ProceduralEqAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -39,13 +45,28 @@ ProceduralEqAudioProcessor::ProceduralEqAudioProcessor()
     )
 #endif 
 {
-    lastSampleRate = getSampleRate();
+    if (getSampleRate() > 0.0)
+        lastSampleRate = getSampleRate();
+
+    //id -> (band, field) once up front, so parameterChanged is a hash lookup instead of a scan of params
+    for (int i = 0; i < params.size(); ++i) {
+        if (i < MAX_EQS * 6)
+            paramSlots[params[i]] = { i / 6, i % 6 };
+        else
+            paramSlots[params[i]] = { -1, i - MAX_EQS * 6 };
+    }
+    for (int i = 0; i < MAX_EQS; ++i)
+        paramSlots[engineParams[i]] = { i, 6 };
 
     for (auto& id : params)
         tree.addParameterListener(id, this);
+    for (auto& id : engineParams)
+        tree.addParameterListener(id, this);
+    tree.addParameterListener("oversampling", this);
+    tree.addParameterListener("filterDesign", this);
+    oversamplingOrder = juce::jlimit(0, MAX_OVERSAMPLING_ORDER, (int)*tree.getRawParameterValue("oversampling"));
 
     for (int i = 0; i < MAX_EQS; ++i) {
-        filters.emplace_back(MultiFilter(Coeffs::makePeakFilter(lastSampleRate, 250.0f + 500.0f * i, 0.1f, 0)));
         auto& req = pendingUpdates[i];
         req.freq.store(*tree.getRawParameterValue(params[0 + i * 6]));
         req.gain.store(*tree.getRawParameterValue(params[1 + i * 6]));
@@ -53,19 +74,42 @@ ProceduralEqAudioProcessor::ProceduralEqAudioProcessor()
         req.type.store(static_cast<int>(*tree.getRawParameterValue(params[3 + i * 6])));
         req.bypass.store(*tree.getRawParameterValue(params[4 + i * 6]) >= 0.5f);
         req.isInit.store(*tree.getRawParameterValue(params[5 + i * 6]) >= 0.5f);
-        req.dirty.store(true);
+        req.engine.store(static_cast<int>(*tree.getRawParameterValue(engineParams[i])));
     }
     analyserOnParam = tree.getRawParameterValue("analyserOn");
     analyserModeParam = tree.getRawParameterValue("analyserMode");
+    analyserOverlapParam = tree.getRawParameterValue("analyserOverlap");
+    analyserWindowParam = tree.getRawParameterValue("analyserWindow");
+    analyserAveragingParam = tree.getRawParameterValue("analyserAveraging");
+    analyserSmoothingParam = tree.getRawParameterValue("analyserSmoothing");
+    analyserBinModeParam = tree.getRawParameterValue("analyserBinMode");
+    analyserPeakHoldParam = tree.getRawParameterValue("analyserPeakHold");
+    analyserPeakDecayParam = tree.getRawParameterValue("analyserPeakDecay");
+    filterStructureParam = tree.getRawParameterValue("filterStructure");
+    filterDesignParam = tree.getRawParameterValue("filterDesign");
+    linearPhaseParam = tree.getRawParameterValue("linearPhase");
+    smoothingTimeParam = tree.getRawParameterValue("smoothingTime");
+    smoothingIntervalParam = tree.getRawParameterValue("smoothingInterval");
+    analyserFifo = std::make_unique<AnalyserFifo<float>>(fftSize * 8);
 
-    for (int i = 0; i < MAX_EQS; ++i)
-        guiCoeffs[i] = *filters[i].state;
     updateAllFilters();
+    drainDirtyBands();
+    linearPhaseBuilder = std::make_unique<LinearPhaseBuilder>(*this, *builderThread);
+    parallelFormBuilder = std::make_unique<ParallelFormBuilder>(*this, *builderThread);
+    startTimer(drainIntervalMs);
 }
 
 ProceduralEqAudioProcessor::~ProceduralEqAudioProcessor() {
+    stopTimer();
     for (auto& id : params)
         tree.removeParameterListener(id, this);
+    for (auto& id : engineParams)
+        tree.removeParameterListener(id, this);
+    tree.removeParameterListener("oversampling", this);
+    tree.removeParameterListener("filterDesign", this);
+    //the builders read the bands, so they have to stop before anything else goes
+    parallelFormBuilder.reset();
+    linearPhaseBuilder.reset();
 }
 
 //==============================================================================
@@ -97,8 +141,36 @@ bool ProceduralEqAudioProcessor::isMidiEffect() const {
 #endif
 }
 
+//how long the slowest ringing band takes to die away once the input stops, or the whole
+//kernel when it's linear phase
 double ProceduralEqAudioProcessor::getTailLengthSeconds() const {
-    return 0.0;
+    if (const int length = getLinearPhaseLength(); length > 0)
+        return (getLinearPhasePartitionSize() + length) / lastSampleRate;
+
+    const double sampleRate = getDesignSampleRate();
+    int tail = 0;
+    for (int i = 0; i < MAX_EQS; ++i) {
+        BandDesign design;
+        getGuiDesign(i, design);
+        tail = juce::jmax(tail, getTailSamples(design, sampleRate));
+    }
+    return tail / sampleRate;
+}
+
+//samples until the band's slowest pole has decayed by tailDecayDb, a band that isn't
+//filtering anything has no state to ring out
+int ProceduralEqAudioProcessor::getTailSamples(const BandDesign& design, double sampleRate) {
+    if (!design.active)
+        return 0;
+
+    const auto maxTail = sampleRate * maxTailSeconds;
+    const auto radius = design.coeffs.getPoleRadius();
+    if (radius >= 1.0)
+        return (int)maxTail;
+
+    //the zeros add two samples of memory on top of the poles
+    const auto decay = radius > 0.0 ? tailDecayDb / (20.0 * std::log10(radius)) : 0.0;
+    return (int)std::ceil(juce::jmin(decay, maxTail)) + 2;
 }
 
 int ProceduralEqAudioProcessor::getNumPrograms() {
@@ -125,31 +197,92 @@ void ProceduralEqAudioProcessor::prepareToPlay(double sampleRate, int samplesPer
     spec.maximumBlockSize = samplesPerBlock;
     spec.numChannels = getTotalNumOutputChannels();
 
-    for (auto& filter : filters) {
-        filter.prepare(spec);
-        filter.reset();
+    //the analyser downmix takes every channel of the bus except the LFE
+    const auto lfe = getChannelLayoutOfBus(false, 0).getChannelIndexForType(juce::AudioChannelSet::LFE);
+    numAnalyserChannels = 0;
+    for (int ch = 0; ch < juce::jmin((int)spec.numChannels, MAX_CHANNELS); ++ch)
+        if (ch != lfe)
+            analyserChannels[numAnalyserChannels++] = ch;
+
+    //both precisions stay prepared and get every design, the host can switch between
+    //them on the next prepareToPlay and only the one in use is run
+    forEachEngine([this](auto& engines) { engines.prepare(spec); });
+    for (size_t i = 0; i < floatEngines.oversamplers.size(); ++i)
+        oversamplingLatency[i + 1] = juce::roundToInt(floatEngines.oversamplers[i]->getLatencyInSamples());
+    runningOrder = oversamplingOrder;
+    unappliedBands = 0;
+    analyserScratch.setSize(juce::jmax(1, numAnalyserChannels), (int)floatEngines.cascade.subBlockSize);
+
+    //ramps start over from the designs posted below, and pick up the new rate on the next block
+    for (auto& ramp : bandRamps) {
+        ramp.target = {};
+        ramp.ramping = false;
     }
+    numRamping = 0;
+    rampTimeMs = -1.0f;
+    bandTailSamples.fill(0);
+    silentSamples = 0;
+    idle = false;
     updateAllFilters();
-    preGain.prepare(spec);
-    postGain.prepare(spec);
+    drainDirtyBands();
     updateGain(0);
     updateGain(1);
 
-    analyserFifo = std::make_unique<AnalyserFifo<float>>(fftSize * 2);
-    if (analyserFifo) {
-        analyserFifo->clear();
+    //a render with the parallel structure starts on it instead of waiting for the builder
+    requestedParallel = false;
+    runningParallel = false;
+    if (usesParallelStructure())
+        parallelFormBuilder->build();
+
+    //the builder sizes the convolver for the length selected and frees it while linear phase
+    //is off. The audio thread isn't running, so it's emptied for the new spec here and the
+    //first kernel is built right away, linear phase then runs from the first block
+    {
+        const juce::ScopedLock lock(linearPhaseBuilder->getLock());
+        linearPhaseConvolver.release();
+        convolverSpec = spec;
+        convolverInUse = false;
+        convolverResetRequested = false;
+        linearPhaseKernelLength = 0;
     }
+    linearPhaseBuilder->build();
+    runningLinearPhase = linearPhaseKernelLength.load() > 0;
+    if (runningLinearPhase)
+        linearPhaseConvolver.reset();
+
+    //the host asks for the latency straight after this, so it's reported here rather than
+    //waiting for the first block
+    runningLatency = getRunningLatency();
+    setLatencySamples(runningLatency);
+
+    //the editor's analysis thread may be reading, it drops the old samples itself
+    analyserFifo->requestReset();
 }
 
 void ProceduralEqAudioProcessor::releaseResources() {
     // When playback stops, you can use this as an opportunity to free up any
     // spare memory, etc.
-    analyserFifo.reset();
+    // The analyser FIFO lives as long as the processor since the editor's analysis thread reads it
 }
 
+//clears the filter, oversampler and convolver states and lands any ramp on its design,
+//nothing is redesigned. Hosts call it between renders, never during processBlock. The
+//builder may be resizing the convolver, so that's cleared by the next block instead
+void ProceduralEqAudioProcessor::reset() {
+    forEachEngine([](auto& engines) { engines.reset(); });
+    convolverResetRequested = true;
+    for (int i = 0; i < MAX_EQS; ++i)
+        if (bandRamps[i].ramping)
+            finishRamp(i);
+    silentSamples = 0;
+    idle = false;
+}
+
+//any named or discrete layout up to MAX_CHANNELS. All channels share one set of coefficients
+//and the cascade runs them as SIMD lanes, so extra channels cost far less than extra instances
 bool ProceduralEqAudioProcessor::isBusesLayoutSupported(const BusesLayout& layouts) const {
-    if (layouts.getMainOutputChannelSet() != juce::AudioChannelSet::mono()
-        && layouts.getMainOutputChannelSet() != juce::AudioChannelSet::stereo())
+    const auto& output = layouts.getMainOutputChannelSet();
+    if (output.isDisabled() || output.size() > MAX_CHANNELS)
         return false;
 
     if (layouts.getMainOutputChannelSet() != layouts.getMainInputChannelSet())
@@ -159,7 +292,19 @@ bool ProceduralEqAudioProcessor::isBusesLayoutSupported(const BusesLayout& layou
 
 }
 
-void ProceduralEqAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages) {
+void ProceduralEqAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer&) {
+    process(buffer, floatEngines);
+}
+
+//the same eq end to end in double, for hosts that run a 64 bit mix bus. Low, narrow
+//bands at high rates keep their accuracy, and the SIMD kernels run 2 (SSE/NEON) or 4
+//(AVX) doubles per register instead of 4 or 8 floats
+void ProceduralEqAudioProcessor::processBlock(juce::AudioBuffer<double>& buffer, juce::MidiBuffer&) {
+    process(buffer, doubleEngines);
+}
+
+template <typename SampleType>
+void ProceduralEqAudioProcessor::process(juce::AudioBuffer<SampleType>& buffer, FilterEngines<SampleType>& engines) {
     juce::ScopedNoDenormals noDenormals;
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
@@ -167,43 +312,267 @@ void ProceduralEqAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
-    bool analyserBool = analyserFifo && analyserOnParam && *analyserOnParam > 0.5f;
-    if (analyserBool) {
-        if (analyserModeParam && *analyserModeParam < 0.5f) {
-            auto* left = buffer.getReadPointer(0);
-            auto* right = buffer.getNumChannels() > 1 ? buffer.getReadPointer(1) : nullptr;
-            for (int i = 0; i < buffer.getNumSamples(); ++i) {
-                float sample = right ? 0.5f * (left[i] + right[i]) : left[i];
-                analyserFifo->push(sample);
-            }
+    const bool analyserBool = analyserFifo && analyserOnParam && *analyserOnParam > 0.5f;
+    const bool preTap = analyserBool && analyserModeParam && *analyserModeParam < 0.5f;
+    const bool postTap = analyserBool && analyserModeParam && *analyserModeParam >= 0.5f;
+
+    //designs are only picked up here, they're made off the audio thread (see timerCallback).
+    //They're tagged with the rate they were made for. A new factor changes that rate and
+    //the states don't carry over, so it only takes over once every band has a design for it.
+    //Until then the old factor keeps running on the designs made for it
+    for (int i = 0; i < MAX_EQS; ++i)
+        if (bandMailboxes[i].read(postedDesigns[i]))
+            unappliedBands |= 1u << i;
+
+    const int order = oversamplingOrder.load(std::memory_order_relaxed);
+    if (order != runningOrder) {
+        const double newRate = spec.sampleRate * (1 << order);
+        if (std::all_of(postedDesigns.begin(), postedDesigns.end(), [newRate](const BandDesign& d) { return d.designRate == newRate; })) {
+            runningOrder = order;
+            engines.reset();
         }
     }
 
-    juce::dsp::AudioBlock<float> block(buffer);
-    juce::dsp::ProcessContextReplacing<float> context(block);
+    if (parallelMailbox.read(parallelDesign))
+        forEachEngine([this](auto& e) { e.parallelBank.setDesign(parallelDesign.direct, parallelDesign.sections.data()); });
+
+    //switching structure starts the other engine from silence, their states don't map onto each other.
+    //The form isn't kept up to date while serial, so switching over waits for one built since
+    const bool wantsParallel = usesParallelStructure();
+    if (wantsParallel && !requestedParallel)
+        parallelRequestGeneration = getDesignGeneration();
+    requestedParallel = wantsParallel;
+    const bool useParallel = wantsParallel && parallelDesign.valid && (int32_t)(parallelDesign.generation - parallelRequestGeneration) >= 0
+                             && (parallelDesign.designRate == 0.0 || parallelDesign.designRate == getRunningDesignRate());
+    if (useParallel != runningParallel) {
+        runningParallel = useParallel;
+        if (useParallel)
+            engines.parallelBank.reset();
+        else
+            engines.cascade.reset();
+    }
 
-    preGain.process(context);
+    //the convolver takes over once a kernel for the current bands has been posted, and hands
+    //back once the builder has seen linear phase switched off or has to resize it. The flag
+    //goes up before the length is looked at again, sizeLinearPhaseConvolver does the same
+    //the other way round, so the builder never resizes it under this block
+    bool useLinearPhase = linearPhaseKernelLength.load(std::memory_order_acquire) > 0;
+    if (useLinearPhase) {
+        convolverInUse.store(true);
+        useLinearPhase = linearPhaseKernelLength.load() > 0;
+    }
+    if (!useLinearPhase)
+        convolverInUse.store(false, std::memory_order_release);
+
+    const bool resetConvolver = convolverResetRequested.exchange(false, std::memory_order_relaxed);
+    if (useLinearPhase != runningLinearPhase) {
+        runningLinearPhase = useLinearPhase;
+        if (useLinearPhase)
+            linearPhaseConvolver.reset();
+        else
+            engines.reset();
+    }
+    else if (resetConvolver && runningLinearPhase) {
+        linearPhaseConvolver.reset();
+    }
 
+    //the host hears about a new latency once the path that has it is actually running.
+    //setLatencySamples calls back into the host, so the timer passes it on
+    runningLatency.store(getRunningLatency(), std::memory_order_relaxed);
+
+    //a new ramp length only applies to ramps started after it, anything in flight lands now
+    const float smoothingMs = smoothingTimeParam ? smoothingTimeParam->load() : 0.0f;
+    if (smoothingMs != rampTimeMs) {
+        rampTimeMs = smoothingMs;
+        for (int i = 0; i < MAX_EQS; ++i) {
+            auto& ramp = bandRamps[i];
+            ramp.freq.reset(spec.sampleRate, rampTimeMs * 0.001);
+            ramp.quality.reset(spec.sampleRate, rampTimeMs * 0.001);
+            ramp.gainDb.reset(spec.sampleRate, rampTimeMs * 0.001);
+            if (ramp.ramping)
+                finishRamp(i);
+        }
+    }
+
+    //only the cascade is smoothed, the parallel form is rebuilt from every band at once
+    //and keeps switching designs at block boundaries, the linear phase kernel crossfades
+    const bool smoothing = rampTimeMs > 0.0f && !runningParallel && !runningLinearPhase;
     for (int i = 0; i < MAX_EQS; ++i) {
-        auto& req = pendingUpdates[i];
-        if (req.dirty.exchange(false))
-            updateFilter(i, req);
-        if (!req.bypass && req.isInit)
-            filters[i].process(context);
+        if ((unappliedBands & (1u << i)) != 0 && postedDesigns[i].designRate == getRunningDesignRate()) {
+            unappliedBands &= ~(1u << i);
+            applyDesign(i, postedDesigns[i], smoothing);
+        }
+        else if (!smoothing && bandRamps[i].ramping) {
+            finishRamp(i);
+        }
     }
 
-    postGain.process(context);
+    const int tailSamples = runningLinearPhase ? linearPhaseConvolver.getLatency() + linearPhaseKernelLength.load(std::memory_order_relaxed)
+                          : *std::max_element(bandTailSamples.begin(), bandTailSamples.end()) + oversamplingLatency[(size_t)runningOrder];
+
+    //one pass per cache sized sub-block: silence check, tap, pre gain, every band, post gain,
+    //tap. The gains ride along with the copies in and out of the cascade's SIMD lanes. While a band
+    //is ramping the sub-blocks shrink to the control interval and the ramping bands are
+    //redesigned at the start of each, so the cost follows the audio, not the host's blocks.
+    //With oversampling only the filters run at the higher rate, and the sub-blocks shrink
+    //by the factor so the oversampled one still fits the cascade's. Linear phase runs at
+    //the host rate, the kernel already has the oversampled designs' response
+    juce::dsp::AudioBlock<SampleType> block(buffer);
+    const auto pre = static_cast<SampleType>(preGain.load(std::memory_order_relaxed));
+    const auto post = static_cast<SampleType>(postGain.load(std::memory_order_relaxed));
+    const int numSamples = buffer.getNumSamples();
+    const int subBlockSize = (int)engines.cascade.subBlockSize >> runningOrder;
+    const int controlInterval = 8 << juce::jlimit(0, 3, smoothingIntervalParam ? (int)smoothingIntervalParam->load() : 2);
+
+    auto filter = [&](juce::dsp::AudioBlock<SampleType> sub) {
+        if (runningParallel)
+            engines.parallelBank.process(juce::dsp::ProcessContextReplacing<SampleType>(sub), pre, post);
+        else
+            engines.cascade.process(juce::dsp::ProcessContextReplacing<SampleType>(sub), pre, post);
+    };
+
+    for (int start = 0; start < numSamples;) {
+        const int num = juce::jmin(numRamping > 0 ? juce::jmin(controlInterval, subBlockSize) : subBlockSize, numSamples - start);
+        auto sub = block.getSubBlock((size_t)start, (size_t)num);
+
+        if (numRamping > 0)
+            advanceRamps(num);
+
+        //idle once the input has been silent for as long as the slowest band takes to ring
+        //out. The states are then down at the noise floor, so they're cleared and filtering
+        //stops until the input comes back. A ramp has to land first, it still moves the poles.
+        //The sub-block is checked as it comes up, so it's read while it's in cache anyway
+        const bool inputSilent = isSilent(sub);
+        const bool wasIdle = idle;
+        idle = inputSilent && numRamping == 0 && silentSamples >= tailSamples;
+        silentSamples = inputSilent ? silentSamples + num : 0;
+        if (idle && !wasIdle) {
+            engines.reset();
+            if (runningLinearPhase)
+                linearPhaseConvolver.reset();
+        }
+
+        if (preTap)
+            pushToAnalyser(buffer, start, num);
+
+        if (idle) {
+            if (pre * post != SampleType(1))
+                sub.multiplyBy(pre * post);
+        }
+        else if (runningLinearPhase) {
+            linearPhaseConvolver.process(juce::dsp::ProcessContextReplacing<SampleType>(sub), pre, post);
+        }
+        else if (runningOrder > 0) {
+            auto& oversampler = *engines.oversamplers[(size_t)runningOrder - 1];
+            filter(oversampler.processSamplesUp(sub));
+            oversampler.processSamplesDown(sub);
+        }
+        else {
+            filter(sub);
+        }
+
+        if (postTap)
+            pushToAnalyser(buffer, start, num);
+        start += num;
+    }
+}
 
-    if (analyserBool) {
-        if (analyserModeParam && *analyserModeParam >= 0.5f) {
-            auto* left = buffer.getReadPointer(0);
-            auto* right = buffer.getNumChannels() > 1 ? buffer.getReadPointer(1) : nullptr;
-            for (int i = 0; i < buffer.getNumSamples(); ++i) {
-                float sample = right ? 0.5f * (left[i] + right[i]) : left[i];
-                analyserFifo->push(sample);
-            }
+//ramps when the band stays on with the same type, anything else (bypass, init, a type
+//change, the first design after prepare) switches straight over like without smoothing
+void ProceduralEqAudioProcessor::applyDesign(int band, const BandDesign& design, bool smoothing) {
+    auto& ramp = bandRamps[band];
+    bandTailSamples[band] = (getTailSamples(design, getRunningDesignRate()) >> runningOrder) + 1;
+    const bool canRamp = smoothing && design.on && ramp.target.on && design.type == ramp.target.type && design.useSvf == ramp.target.useSvf
+                         && design.matched == ramp.target.matched;
+    ramp.target = design;
+
+    if (canRamp) {
+        ramp.freq.setTargetValue(design.freq);
+        ramp.quality.setTargetValue(design.quality);
+        ramp.gainDb.setTargetValue(design.gainDb);
+        if (ramp.freq.isSmoothing() || ramp.quality.isSmoothing() || ramp.gainDb.isSmoothing()) {
+            //a peak or shelf ramping to or from 0 dB has to run even though one end is an identity
+            if (!ramp.ramping)
+                ++numRamping;
+            ramp.ramping = true;
+            forEachEngine([band](auto& e) { e.cascade.setSectionEnabled(band, true); });
+            return;
         }
     }
+    finishRamp(band);
+}
+
+//redesigns every ramping band for the next numSamples, using where its ramp will be at the end of them
+void ProceduralEqAudioProcessor::advanceRamps(int numSamples) {
+    for (int i = 0; i < MAX_EQS; ++i) {
+        auto& ramp = bandRamps[i];
+        if (!ramp.ramping)
+            continue;
+
+        const auto freq = ramp.freq.skip(numSamples);
+        const auto quality = ramp.quality.skip(numSamples);
+        const auto gainDb = ramp.gainDb.skip(numSamples);
+        if (!(ramp.freq.isSmoothing() || ramp.quality.isSmoothing() || ramp.gainDb.isSmoothing()))
+            finishRamp(i);
+        else if (ramp.target.useSvf) {
+            const auto svf = designSvfBand(getRunningDesignRate(), ramp.target.type, freq, gainDb, quality, ramp.target.matched);
+            forEachEngine([&](auto& e) { e.cascade.setCoefficients(i, svf); });
+        }
+        else {
+            const auto coeffs = designBand(getRunningDesignRate(), ramp.target.type, freq, gainDb, quality, ramp.target.matched);
+            forEachEngine([&](auto& e) { e.cascade.setCoefficients(i, coeffs, ramp.target.kind); });
+        }
+    }
+}
+
+//lands the band on its posted design, which is exactly what the ramp was heading for
+void ProceduralEqAudioProcessor::finishRamp(int band) {
+    auto& ramp = bandRamps[band];
+    if (ramp.ramping)
+        --numRamping;
+    ramp.ramping = false;
+    ramp.freq.setCurrentAndTargetValue(ramp.target.freq);
+    ramp.quality.setCurrentAndTargetValue(ramp.target.quality);
+    ramp.gainDb.setCurrentAndTargetValue(ramp.target.gainDb);
+    forEachEngine([&](auto& e) {
+        if (ramp.target.useSvf)
+            e.cascade.setCoefficients(band, ramp.target.svf);
+        else
+            e.cascade.setCoefficients(band, ramp.target.coeffs, ramp.target.kind);
+        e.cascade.setSectionEnabled(band, ramp.target.active);
+    });
+}
+
+//below silenceThreshold on every channel. Outputs without an input were cleared, so they
+//don't count against it
+template <typename SampleType>
+bool ProceduralEqAudioProcessor::isSilent(const juce::dsp::AudioBlock<SampleType>& block) {
+    const auto range = block.findMinAndMax();
+    return juce::jmax(-range.getStart(), range.getEnd()) <= SampleType(silenceThreshold);
+}
+
+//the analyser runs in float, double channels are narrowed into analyserScratch first
+template <typename SampleType>
+void ProceduralEqAudioProcessor::pushToAnalyser(const juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples) {
+    std::array<const float*, MAX_CHANNELS> channels;
+    int numChannels = 0;
+    for (int i = 0; i < numAnalyserChannels; ++i) {
+        if (analyserChannels[i] >= buffer.getNumChannels())
+            continue;
+
+        const auto* src = buffer.getReadPointer(analyserChannels[i], startSample);
+        if constexpr (std::is_same_v<SampleType, float>) {
+            channels[numChannels++] = src;
+        }
+        else {
+            jassert(numSamples <= analyserScratch.getNumSamples());
+            auto* dest = analyserScratch.getWritePointer(numChannels);
+            for (int n = 0; n < numSamples; ++n)
+                dest[n] = (float)src[n];
+            channels[numChannels++] = dest;
+        }
+    }
+    analyserFifo->pushBlock(channels.data(), numChannels, numSamples);
 }
 
 //==============================================================================
@@ -227,6 +596,8 @@ void ProceduralEqAudioProcessor::setStateInformation(const void* data, int sizeI
     if (readData.isValid()) {
         tree.replaceState(readData);
         updateAllFilters();
+        //designed straight away, the curve and the tail length mustn't wait for the timer
+        drainDirtyBands();
     }
 }
 
@@ -276,47 +647,235 @@ juce::AudioProcessorValueTreeState::ParameterLayout ProceduralEqAudioProcessor::
     }
     layout.add(std::make_unique<juce::AudioParameterFloat>(params[72], params[72], -72.0f, 24.0f, 0.0f));
     layout.add(std::make_unique<juce::AudioParameterFloat>(params[73], params[73], -72.0f, 24.0f, 0.0f));
+    //biquad or trapezoidal svf per band, same response either way
+    for (int i = 0; i < MAX_EQS; ++i)
+        layout.add(std::make_unique<juce::AudioParameterChoice>(engineParams[i], engineParams[i], engines, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("filterStructure", "Filter Structure", juce::StringArray{ "Serial", "Parallel" }, 0));
+    //bilinear (RBJ) designs cramp towards nyquist, matched ones follow the analog curve up to it
+    layout.add(std::make_unique<juce::AudioParameterChoice>("filterDesign", "Filter Design", juce::StringArray{ "Bilinear", "Matched" }, 0));
+    //how long freq, gain and Q take to glide to a new value (0 switches at block boundaries), and
+    //how many samples pass between redesigns while they do. Off unless asked for, so sessions
+    //saved before smoothing existed render the way they always did
+    layout.add(std::make_unique<juce::AudioParameterFloat>("smoothingTime", "Smoothing Time", juce::NormalisableRange<float>(0.0f, 500.0f, 1.0f, 0.5f), 0.0f, juce::AudioParameterFloatAttributes()
+        .withStringFromValueFunction([](float value, int) {
+            return value <= 0.0f ? juce::String("Off") : juce::String(value, 0) + " ms";
+            })
+    ));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("smoothingInterval", "Smoothing Interval", juce::StringArray{ "8 Samples", "16 Samples", "32 Samples", "64 Samples" }, 2));
+    //runs the filters at 2, 4 or 8 times the rate so bands near nyquist keep their analog shape.
+    //Changes the latency, so it's left out of automation
+    layout.add(std::make_unique<juce::AudioParameterChoice>("oversampling", "Oversampling", juce::StringArray{ "Off", "2x", "4x", "8x" }, 0,
+        juce::AudioParameterChoiceAttributes().withAutomatable(false)));
+    //runs the bands' combined magnitude as one linear phase FIR instead of the filters. Longer
+    //kernels resolve lower, narrower bands but add latency (53, 181 and 693 ms at 48 kHz)
+    layout.add(std::make_unique<juce::AudioParameterChoice>("linearPhase", "Linear Phase", juce::StringArray{ "Off", "Short", "Medium", "Long" }, 0,
+        juce::AudioParameterChoiceAttributes().withAutomatable(false)));
     layout.add(std::make_unique<juce::AudioParameterBool>("analyserOn", "Analyser On", true));
     layout.add(std::make_unique<juce::AudioParameterChoice>("analyserMode", "Analyser Mode", juce::StringArray{ "Pre-EQ", "Post-EQ" }, 1));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("analyserOverlap", "Analyser Overlap", juce::StringArray{ "50%", "75%" }, 0));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("analyserWindow", "Analyser Window", juce::StringArray{ "Hann", "Hamming", "Blackman", "Blackman-Harris", "Flat Top" }, 0));
+    //exponential averaging time constant, 0 is no averaging
+    layout.add(std::make_unique<juce::AudioParameterFloat>("analyserAveraging", "Analyser Averaging", juce::NormalisableRange<float>(0.0f, 2000.0f, 1.0f, 0.5f), 250.0f, juce::AudioParameterFloatAttributes()
+        .withStringFromValueFunction([](float value, int) {
+            return juce::String(value, 0) + " ms";
+            })
+    ));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("analyserSmoothing", "Analyser Smoothing", juce::StringArray{ "Off", "1/24 Oct", "1/12 Oct", "1/6 Oct", "1/3 Oct" }, 2));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("analyserBinMode", "Analyser Bin Mode", juce::StringArray{ "Average", "Max" }, 0));
+    layout.add(std::make_unique<juce::AudioParameterBool>("analyserPeakHold", "Analyser Peak Hold", false));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("analyserPeakDecay", "Analyser Peak Decay", juce::NormalisableRange<float>(1.0f, 60.0f, 0.5f), 12.0f, juce::AudioParameterFloatAttributes()
+        .withStringFromValueFunction([](float value, int) {
+            return juce::String(value, 1) + " dB/s";
+            })
+    ));
     return layout;
 }
 
+//parameterChanged only marks bands, so however many changes land between two drains each
+//band is designed once. Bands marked while a drain is running stay marked for the next one
+void ProceduralEqAudioProcessor::drainDirtyBands() {
+    const juce::SpinLock::ScopedLockType lock(drainLock);
+    const auto dirty = dirtyBands.exchange(0, std::memory_order_acq_rel);
+    if (dirty == 0)
+        return;
+
+    for (int i = 0; i < MAX_EQS; ++i)
+        if ((dirty & (1u << i)) != 0)
+            updateFilter(i, pendingUpdates[i]);
+    designGeneration.fetch_add(1, std::memory_order_release);
+}
+
+//host automation can arrive on the audio thread, which only marks the band. This picks
+//it up on the message thread whether or not the editor is open, wakes the builders that
+//have something to do and reports the latency of whatever path the audio thread has
+//switched to
+void ProceduralEqAudioProcessor::timerCallback() {
+    drainDirtyBands();
+    parallelFormBuilder->update();
+    linearPhaseBuilder->update();
+
+    if (const int latency = runningLatency.load(std::memory_order_relaxed); latency != getLatencySamples())
+        setLatencySamples(latency);
+}
+
+//designs the band and posts it, only drainDirtyBands calls this
 void ProceduralEqAudioProcessor::updateFilter(int ind, const FilterUpdateReq& req) {
-    auto c = makeCoefficients(req);
-    *filters[ind].state = c;
-    guiCoeffs[ind] = c;
+    BandDesign design;
+    design.designRate = getDesignSampleRate();  //once, the factor can change under us
+    design.coeffs = makeCoefficients(req, design.designRate);
+    design.matched = usesMatchedDesign();
+    design.kind = getSectionKind(req.type, design.matched);
+    design.svf = makeSvfCoefficients(req, design.designRate);
+    design.useSvf = req.engine == 1;
+    design.active = changesSignal(req);
+    design.on = !req.bypass && req.isInit;
+    design.type = req.type;
+    design.freq = req.freq;
+    design.gainDb = req.gain;
+    design.quality = req.quality;
+    bandMailboxes[ind].write(design);
+    guiDesigns[ind].write(design);
+}
+
+//peaks and shelves at 0 dB are identities, so they're left out of the cascade
+bool ProceduralEqAudioProcessor::changesSignal(const FilterUpdateReq& req) {
+    if (req.bypass || !req.isInit)
+        return false;
+
+    const int type = req.type;
+    if (type == 1 || type == 2)
+        return true;
+
+    return std::abs(req.gain.load()) > 1.0e-4f;
+}
+
+//the matched peak and low pass numerators have no symmetry to exploit, the high pass keeps
+//its double zero at DC so it still fits the cut kernel
+SectionKind ProceduralEqAudioProcessor::getSectionKind(int type, bool matched) {
+    if (matched && (type == 0 || type == 2))
+        return SectionKind::shelf;
+
+    switch (type) {
+    case 0: return SectionKind::peak;
+    case 1: return SectionKind::highPass;
+    case 2: return SectionKind::lowPass;
+    default: return SectionKind::shelf;
+    }
 }
 
 void ProceduralEqAudioProcessor::parameterChanged(const juce::String& paramID, float newValue) {
-    for (int i = 0; i < MAX_EQS; ++i) {
-        for (int p = 0; p < 6; ++p) {
-            if (params[p + i * 6] == paramID) {
-                auto& req = pendingUpdates[i];
-                switch (p) {
-                case 0: req.freq = newValue; break;
-                case 1: req.gain = newValue; break;
-                case 2: req.quality = newValue; break;
-                case 3: req.type = static_cast<int>(newValue); break;
-                case 4: req.bypass = (newValue >= 0.5f); break;
-                case 5: req.isInit = (newValue >= 0.5f); break;
-                }
-                req.dirty = true;
-                guiCoeffs[i] = makeCoefficients(req);
-                return;
-            }
-        }
+    if (paramID == "oversampling") {
+        setOversampling((int)newValue);
+        return;
+    }
+    if (paramID == "filterDesign") {
+        updateAllFilters();
+        return;
     }
-    if (params[72] == paramID)
-        updateGain(0);
-        
-    else if (params[73] == paramID)
-        updateGain(1);
 
+    auto it = paramSlots.find(paramID);
+    if (it == paramSlots.end())
+        return;
+
+    const auto slot = it->second;
+    if (slot.band < 0) {
+        updateGain(slot.field);
+        return;
+    }
+
+    auto& req = pendingUpdates[slot.band];
+    switch (slot.field) {
+    case 0: req.freq = newValue; break;
+    case 1: req.gain = newValue; break;
+    case 2: req.quality = newValue; break;
+    case 3: req.type = static_cast<int>(newValue); break;
+    case 4: req.bypass = (newValue >= 0.5f); break;
+    case 5: req.isInit = (newValue >= 0.5f); break;
+    case 6: req.engine = static_cast<int>(newValue); break;
+    }
+    //only marks the band, it's designed by the next drain
+    if (affectsDesign(req, slot.field))
+        dirtyBands.fetch_or(1u << slot.band, std::memory_order_acq_rel);
+    bandVersions[slot.band].fetch_add(1, std::memory_order_release);
+}
+
+//a band that's off, or a cut's gain, doesn't change what gets posted. The stored value is
+//picked up by the next design that does (bypass/init always redesign)
+bool ProceduralEqAudioProcessor::affectsDesign(const FilterUpdateReq& req, int field) {
+    if (field == 4 || field == 5)
+        return true;
+    if (req.bypass || !req.isInit)
+        return false;
+    if (field == 1 && (req.type == 1 || req.type == 2))
+        return false;
+    return true;
+}
+
+//marks every band for a redesign at the new rate. The audio thread switches once the
+//designs for the new rate have all arrived, and reports the half-bands' latency then
+void ProceduralEqAudioProcessor::setOversampling(int order) {
+    oversamplingOrder = juce::jlimit(0, MAX_OVERSAMPLING_ORDER, order);
+    updateAllFilters();
+}
+
+//linear phase runs instead of the oversampled filters, so it's one latency or the other.
+//The kernel is centred, half of it plus the convolver's partition. Audio thread, or
+//prepareToPlay while it isn't running
+int ProceduralEqAudioProcessor::getRunningLatency() const {
+    if (runningLinearPhase)
+        return linearPhaseConvolver.getLatency() + linearPhaseKernelLength.load(std::memory_order_relaxed) / 2;
+    return oversamplingLatency[(size_t)runningOrder];
 }
 
+int ProceduralEqAudioProcessor::getRateMultiple(double sampleRate) {
+    return juce::jlimit(0, 3, juce::roundToInt(std::log2(sampleRate / 48000.0)));
+}
+
+//Short, Medium and Long are 4096, 16384 and 65536 taps at 44.1 and 48 kHz, doubled with
+//every doubling of the rate so the resolution in Hz stays put
+int ProceduralEqAudioProcessor::getLinearPhaseLength(int choice, double sampleRate) {
+    choice = juce::jlimit(0, 3, choice);
+    if (choice == 0)
+        return 0;
+    return (1024 << (2 * choice)) << getRateMultiple(sampleRate);
+}
+
+int ProceduralEqAudioProcessor::getLinearPhaseLength() const {
+    return getLinearPhaseLength(linearPhaseParam ? (int)linearPhaseParam->load() : 0, lastSampleRate);
+}
+
+//only the builder calls this, under its lock. A longer length than the convolver holds, or
+//0, needs it resized or freed, which can only happen with the audio thread off it. The
+//length goes to 0 first, which hands the filters back, and while the last block still
+//ran the convolver this returns false and the builder tries again on the next timer tick.
+//A shorter length fits what's there, so stepping down never drops out of linear phase
+bool ProceduralEqAudioProcessor::sizeLinearPhaseConvolver(int length) {
+    const int prepared = linearPhaseConvolver.getMaxKernelLength();
+    if (length == 0 ? prepared == 0 : length <= prepared)
+        return true;
+
+    linearPhaseKernelLength.store(0);
+    if (convolverInUse.load())
+        return false;
+
+    if (length > 0)
+        linearPhaseConvolver.prepare(convolverSpec, getLinearPhasePartitionSize(), length);
+    else
+        linearPhaseConvolver.release();
+    return true;
+}
+
+//only the builder calls this, under its lock. The audio thread switches over once the
+//length is up, by which time the kernel is waiting in the convolver
+void ProceduralEqAudioProcessor::setLinearPhaseKernel(const float* kernel, int length) {
+    if (length > 0 && !linearPhaseConvolver.setKernel(kernel, length))
+        length = 0;
+    linearPhaseKernelLength.store(length, std::memory_order_release);
+}
+
+//marks every band, they're redesigned by the next drain
 void ProceduralEqAudioProcessor::updateAllFilters() {
-    for (int i = 0; i < MAX_EQS; ++i)
-        updateFilter(i, pendingUpdates[i]);
+    dirtyBands.fetch_or((1u << MAX_EQS) - 1, std::memory_order_acq_rel);
 }
 
 //give eq ind, param ind, and 0 to 1 value to change
@@ -328,18 +887,62 @@ void ProceduralEqAudioProcessor::updateParameter(int id, int paramInd, float new
     }
 }
 
-ProceduralEqAudioProcessor::Coeffs ProceduralEqAudioProcessor::makeCoefficients(const FilterUpdateReq& req) const
+BiquadCoeffs ProceduralEqAudioProcessor::makeCoefficients(const FilterUpdateReq& req, double sampleRate) const
+{
+    if (req.bypass || !req.isInit)
+        return FilterDesign::makeIdentity();
+
+    return designBand(sampleRate, req.type, req.freq, req.gain, req.quality, usesMatchedDesign());
+}
+
+SvfCoeffs ProceduralEqAudioProcessor::makeSvfCoefficients(const FilterUpdateReq& req, double sampleRate) const
 {
     if (req.bypass || !req.isInit)
-        return *Coeffs::makeAllPass(lastSampleRate, 1000.0f);
-
-    switch (req.type) {
-    case 0: return *Coeffs::makePeakFilter(lastSampleRate, req.freq, req.quality, juce::Decibels::decibelsToGain(float(req.gain), -80.0f));
-    case 1: return *Coeffs::makeHighPass(lastSampleRate, req.freq, req.quality);
-    case 2: return *Coeffs::makeLowPass(lastSampleRate, req.freq, req.quality);
-    case 3: return *Coeffs::makeHighShelf(lastSampleRate, req.freq, req.quality, juce::Decibels::decibelsToGain(float(req.gain), -80.0f));
-    case 4: return *Coeffs::makeLowShelf(lastSampleRate, req.freq, req.quality, juce::Decibels::decibelsToGain(float(req.gain), -80.0f));
-    default: return *Coeffs::makeAllPass(lastSampleRate, 1000.0f);
+        return {};
+
+    return designSvfBand(sampleRate, req.type, req.freq, req.gain, req.quality, usesMatchedDesign());
+}
+
+//allocation free, the audio thread calls it for ramping bands
+BiquadCoeffs ProceduralEqAudioProcessor::designBand(double sampleRate, int type, double freq, double gainDb, double quality, bool matched)
+{
+    const double gainFactor = FastMath::decibelsToGain((float)gainDb, -80.0f);
+    if (matched) {
+        switch (type) {
+        case 0: return FilterDesign::makeMatchedPeakFilter(sampleRate, freq, quality, gainFactor);
+        case 1: return FilterDesign::makeMatchedHighPass(sampleRate, freq, quality);
+        case 2: return FilterDesign::makeMatchedLowPass(sampleRate, freq, quality);
+        case 3: return FilterDesign::makeMatchedHighShelf(sampleRate, freq, quality, gainFactor);
+        case 4: return FilterDesign::makeMatchedLowShelf(sampleRate, freq, quality, gainFactor);
+        default: return FilterDesign::makeIdentity();
+        }
+    }
+
+    switch (type) {
+    case 0: return FilterDesign::makePeakFilter(sampleRate, freq, quality, gainFactor);
+    case 1: return FilterDesign::makeHighPass(sampleRate, freq, quality);
+    case 2: return FilterDesign::makeLowPass(sampleRate, freq, quality);
+    case 3: return FilterDesign::makeHighShelf(sampleRate, freq, quality, gainFactor);
+    case 4: return FilterDesign::makeLowShelf(sampleRate, freq, quality, gainFactor);
+    default: return FilterDesign::makeIdentity();
+    }
+}
+
+//the cheap path for modulation, one tan per call. Matched designs aren't bilinear, so
+//they're made as biquads and converted
+SvfCoeffs ProceduralEqAudioProcessor::designSvfBand(double sampleRate, int type, double freq, double gainDb, double quality, bool matched)
+{
+    if (matched)
+        return FilterDesign::makeSvfFromBiquad(designBand(sampleRate, type, freq, gainDb, quality, true));
+
+    const double gainFactor = FastMath::decibelsToGain((float)gainDb, -80.0f);
+    switch (type) {
+    case 0: return FilterDesign::makeSvfPeakFilter(sampleRate, freq, quality, gainFactor);
+    case 1: return FilterDesign::makeSvfHighPass(sampleRate, freq, quality);
+    case 2: return FilterDesign::makeSvfLowPass(sampleRate, freq, quality);
+    case 3: return FilterDesign::makeSvfHighShelf(sampleRate, freq, quality, gainFactor);
+    case 4: return FilterDesign::makeSvfLowShelf(sampleRate, freq, quality, gainFactor);
+    default: return {};
     }
 }
 
@@ -349,14 +952,11 @@ void ProceduralEqAudioProcessor::resetEq(int ind) {
     updateParameter(ind, 3, 0);
     updateParameter(ind, 4, 1);
     updateParameter(ind, 5, 0);
-    auto allpass = *Coeffs::makeAllPass(lastSampleRate, 1000.0f);
-    guiCoeffs[ind] = allpass;
-    *filters[ind].state = allpass;
 }
 
 void ProceduralEqAudioProcessor::updateGain(int id) {
     if (id == 0)
-        preGain.setGainDecibels(tree.getRawParameterValue(params[72])->load());
+        preGain.store(FastMath::decibelsToGain(tree.getRawParameterValue(params[72])->load()), std::memory_order_relaxed);
     else if (id == 1)
-        postGain.setGainDecibels(tree.getRawParameterValue(params[73])->load());
+        postGain.store(FastMath::decibelsToGain(tree.getRawParameterValue(params[73])->load()), std::memory_order_relaxed);
 }
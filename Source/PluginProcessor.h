@@ -9,29 +9,46 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BiquadCascade.h"
+#include "ParallelFilterBank.h"
+#include "FilterDesign.h"
+#include "FastMath.h"
+#include "LockFree.h"
+#include "PartitionedConvolver.h"
+#include "LinearPhaseBuilder.h"
+#include "ParallelFormBuilder.h"
 
 //==============================================================================
 /**
 */
-// Simple lock-free FIFO using AbstractFifo
+// Block-oriented single producer/single consumer FIFO using AbstractFifo. The audio
+// thread downmixes a whole block straight into the ring with vector ops, and the
+// analyser pops whole frames. Samples that don't fit and reads that come up short
+// are counted instead of silently dropped.
 template <typename T>
 class AnalyserFifo
 {
 public:
-    AnalyserFifo(int capacity) : fifo(capacity), buffer(capacity) {}
+    AnalyserFifo(int capacity) : fifo(capacity), buffer((size_t)capacity) {}
+
+    //averages numChannels channels into the ring, returns how many samples were written
+    int pushBlock(const T* const* channels, int numChannels, int numSamples) {
+        if (numChannels <= 0 || numSamples <= 0)
+            return 0;
 
-    bool push(T sample) {
         int start1, size1, start2, size2;
-        fifo.prepareToWrite(1, start1, size1, start2, size2);
+        fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+        const int numWritten = size1 + size2;
 
-        if (size1 > 0) {
-            buffer[(size_t)start1] = sample;
-        }
-        if (size2 > 0) {
-            buffer[(size_t)start2] = sample;
-        }
-        fifo.finishedWrite(size1 + size2);
-        return (size1 + size2) > 0;
+        if (size1 > 0)
+            downmix(buffer.data() + start1, channels, numChannels, 0, size1);
+        if (size2 > 0)
+            downmix(buffer.data() + start2, channels, numChannels, size1, size2);
+
+        fifo.finishedWrite(numWritten);
+        if (numWritten < numSamples)
+            overflows.fetch_add((uint32_t)(numSamples - numWritten), std::memory_order_relaxed);
+        return numWritten;
     }
 
     int pop(T* dest, int numToRead) {
@@ -40,21 +57,50 @@ public:
         int numRead = size1 + size2;
 
         if (size1 > 0)
-            std::copy(buffer.begin() + start1, buffer.begin() + start1 + size1, dest);
+            std::memcpy(dest, buffer.data() + start1, sizeof(T) * (size_t)size1);
         if (size2 > 0)
-            std::copy(buffer.begin() + start2, buffer.begin() + start2 + size2, dest + size1);
+            std::memcpy(dest + size1, buffer.data() + start2, sizeof(T) * (size_t)size2);
 
         fifo.finishedRead(numRead);
+        if (numRead < numToRead)
+            underruns.fetch_add(1, std::memory_order_relaxed);
         return numRead;
     }
 
-    void clear() {
-        fifo.reset();
+    int getNumReady() const { return fifo.getNumReady(); }
+
+    //samples dropped because the ring was full / pops that came back short
+    uint32_t getNumOverflows() const { return overflows.load(std::memory_order_relaxed); }
+    uint32_t getNumUnderruns() const { return underruns.load(std::memory_order_relaxed); }
+
+    //any thread. AbstractFifo's positions belong to the producer and the consumer, so this
+    //only flags it and the consumer drops what's waiting itself
+    void requestReset() { resetRequested.store(true, std::memory_order_release); }
+
+    //consumer only, skips everything waiting if a reset was requested. True if it did
+    bool skipIfResetRequested() {
+        if (!resetRequested.exchange(false, std::memory_order_acq_rel))
+            return false;
+        fifo.finishedRead(fifo.getNumReady());
+        return true;
     }
 
 private:
+    static void downmix(T* dest, const T* const* channels, int numChannels, int offset, int num) {
+        juce::FloatVectorOperations::copy(dest, channels[0] + offset, num);
+        if (numChannels == 1)
+            return;
+
+        for (int ch = 1; ch < numChannels; ++ch)
+            juce::FloatVectorOperations::add(dest, channels[ch] + offset, num);
+        juce::FloatVectorOperations::multiply(dest, T(1) / T(numChannels), num);
+    }
+
     juce::AbstractFifo fifo;
     std::vector<T> buffer;
+    std::atomic<uint32_t> overflows{ 0 };
+    std::atomic<uint32_t> underruns{ 0 };
+    std::atomic<bool> resetRequested{ false };
 };
 
 //==============================================================================
@@ -64,6 +110,7 @@ private:
 template <typename ValueT>
 juce::NormalisableRange<ValueT> logRange(ValueT min, ValueT max)
 {
+    //host visible normalisation, exact libm here so saved values round trip
     ValueT rng{ std::log(max / min) };
     return { min, max,
         [=](ValueT min, ValueT, ValueT v) { return std::exp(v * rng) * min; },
@@ -93,22 +140,103 @@ static juce::String formatQuality(float value, int decimals = 2)
 /**
 */
 extern juce::StringArray params;
+extern juce::StringArray engineParams;
 inline constexpr int MAX_EQS = 12;
+inline constexpr int MAX_CHANNELS = 16;   //any layout up to this many, mono to 7.1.4 and beyond
+inline constexpr int MAX_OVERSAMPLING_ORDER = 3;  //up to 8x
+static_assert(MAX_EQS <= FilterDesign::maxParallelSections, "every band has to fit in the parallel form");
 
 struct FilterUpdateReq {
-    std::atomic<bool> dirty{ false };
     std::atomic<float> freq{ 500.0f };
     std::atomic<float> gain{ 0.0f };
     std::atomic<float> quality{ 1.0f };
     std::atomic<int> type{ 0 };
     std::atomic<bool> bypass{ true };
     std::atomic<bool> isInit{ false };
+    std::atomic<int> engine{ 0 };   //0 biquad, 1 svf
+};
+
+//finished design for one band, posted to the audio thread through a TripleBuffer. The
+//params it came from go along so the audio thread can ramp towards them when smoothing
+struct BandDesign {
+    BiquadCoeffs coeffs;    //always filled in, the curve and the parallel form work from it
+    SectionKind kind = SectionKind::shelf;
+    SvfCoeffs svf;
+    bool useSvf = false;    //run svf instead of coeffs in the cascade
+    bool matched = false;   //magnitude matched rather than bilinear
+    bool active = false;
+    bool on = false;    //not bypassed and initialised, even if it's currently an identity
+    int type = 0;
+    float freq = 1000.0f;
+    float gainDb = 0.0f;
+    float quality = 1.0f;
+    double designRate = 0.0;    //what the coefficients are for, the host's rate times the oversampling factor
+};
+
+//audio thread's ramp for one band. freq, gain and Q glide towards the last posted design
+//and the section is redesigned from them once per control interval
+struct BandRamp {
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> freq{ 1000.0f };
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> quality{ 1.0f };
+    juce::SmoothedValue<float> gainDb{ 0.0f };
+    BandDesign target;
+    bool ramping = false;
+};
+
+//the filters for one sample type, the processor keeps a float and a double set. There's
+//an oversampler for each factor, all built in prepare so switching never allocates
+template <typename SampleType>
+struct FilterEngines {
+    using Oversampler = juce::dsp::Oversampling<SampleType>;
+
+    BiquadCascade<SampleType, MAX_EQS> cascade;
+    ParallelFilterBank<SampleType, MAX_EQS> parallelBank;
+    std::array<std::unique_ptr<Oversampler>, MAX_OVERSAMPLING_ORDER> oversamplers;  //[order - 1]
+
+    void prepare(const juce::dsp::ProcessSpec& spec) {
+        cascade.prepare(spec);
+        parallelBank.prepare(spec);
+        //polyphase IIR half-bands, the cheapest and lowest latency. Sub-blocks are never longer
+        //than the cascade's, so that's all the oversamplers need room for
+        for (size_t i = 0; i < oversamplers.size(); ++i) {
+            oversamplers[i] = std::make_unique<Oversampler>((size_t)spec.numChannels, i + 1, Oversampler::filterHalfBandPolyphaseIIR, true, true);
+            oversamplers[i]->initProcessing(cascade.subBlockSize);
+        }
+        reset();
+    }
+
+    void reset() {
+        cascade.reset();
+        parallelBank.reset();
+        for (auto& oversampler : oversamplers)
+            if (oversampler)
+                oversampler->reset();
+    }
+};
+
+//all active bands as one parallel form, section i belongs to band i (zero when it's off).
+//valid is false when the conversion was refused, the cascade runs instead then. generation
+//is the processor's design generation the bands were read at, designRate is theirs (0 when
+//there are none and the form is an identity at any rate)
+struct ParallelDesign {
+    double direct = 1.0;
+    std::array<ParallelSection, MAX_EQS> sections{};
+    bool valid = true;
+    uint32_t generation = 0;
+    double designRate = 0.0;
+};
+
+//one low priority thread for every instance's background builds. The processor's timer
+//wakes it with work, so instances that aren't building cost nothing
+struct SharedBuilderThread : juce::TimeSliceThread {
+    SharedBuilderThread() : juce::TimeSliceThread("Eq Builders") { startThread(juce::Thread::Priority::low); }
+    ~SharedBuilderThread() override { stopThread(1000); }
 };
 
 //==============================================================================
 /**
 */
-class ProceduralEqAudioProcessor : public juce::AudioProcessor, juce::AudioProcessorValueTreeState::Listener {
+class ProceduralEqAudioProcessor : public juce::AudioProcessor, juce::AudioProcessorValueTreeState::Listener, juce::Timer {
 public:
     //==============================================================================
     ProceduralEqAudioProcessor();
@@ -117,12 +245,15 @@ public:
     //==============================================================================
     void prepareToPlay(double sampleRate, int samplesPerBlock) override;
     void releaseResources() override;
+    void reset() override;
 
 #ifndef JucePlugin_PreferredChannelConfigurations
     bool isBusesLayoutSupported(const BusesLayout& layouts) const override;
 #endif
 
     void processBlock(juce::AudioBuffer<float>&, juce::MidiBuffer&) override;
+    void processBlock(juce::AudioBuffer<double>&, juce::MidiBuffer&) override;
+    bool supportsDoublePrecisionProcessing() const override { return true; }
 
     //==============================================================================
     juce::AudioProcessorEditor* createEditor() override;
@@ -148,15 +279,17 @@ public:
     void setStateInformation(const void* data, int sizeInBytes) override;
 
     //==============================================================================
-    using Filter = juce::dsp::IIR::Filter<float>;
-    using Coeffs = juce::dsp::IIR::Coefficients<float>;
-    using MultiFilter = juce::dsp::ProcessorDuplicator<Filter, Coeffs>;
-    std::vector<MultiFilter> filters;
+    FilterEngines<float> floatEngines;
+    FilterEngines<double> doubleEngines;
     juce::AudioProcessorValueTreeState::ParameterLayout createParameterLayout();
     juce::AudioProcessorValueTreeState tree{ *this, nullptr, "Parameters", createParameterLayout() };
     void updateAllFilters();
     void updateParameter(int id, int paramInd, float newValue);
-    void updateFilter(int ind, const FilterUpdateReq& req);
+    //designs and posts every band marked since the last call. Never on the audio thread, it
+    //only picks up what's posted. The timer, the editor, prepareToPlay and state restores call it
+    void drainDirtyBands();
+    //bumped after every drain that posted something, the builders compare it with what they built from
+    uint32_t getDesignGeneration() const { return designGeneration.load(std::memory_order_acquire); }
     void resetEq(int ind);
 
     const std::array<FilterUpdateReq, MAX_EQS>& getPendingUpdates() const { return pendingUpdates; }
@@ -165,20 +298,132 @@ public:
     AnalyserFifo<float>* getAnalyserFifo() { return analyserFifo.get(); }
     std::atomic<float>* analyserOnParam = nullptr;
     std::atomic<float>* analyserModeParam = nullptr;
-
-    std::array<Coeffs, MAX_EQS> guiCoeffs;
-    Coeffs makeCoefficients(const FilterUpdateReq& req) const;
+    std::atomic<float>* analyserOverlapParam = nullptr;
+    std::atomic<float>* analyserWindowParam = nullptr;
+    std::atomic<float>* analyserAveragingParam = nullptr;
+    std::atomic<float>* analyserSmoothingParam = nullptr;
+    std::atomic<float>* analyserBinModeParam = nullptr;
+    std::atomic<float>* analyserPeakHoldParam = nullptr;
+    std::atomic<float>* analyserPeakDecayParam = nullptr;
+    std::atomic<float>* filterStructureParam = nullptr;
+    std::atomic<float>* filterDesignParam = nullptr;
+    std::atomic<float>* linearPhaseParam = nullptr;
+    std::atomic<float>* smoothingTimeParam = nullptr;
+    std::atomic<float>* smoothingIntervalParam = nullptr;
+
+    //lock-free view of the last design posted for each band, returns its version
+    uint32_t getGuiDesign(int band, BandDesign& dest) const { return guiDesigns[(size_t)band].read(dest); }
+    uint32_t getGuiVersion(int band) const { return guiDesigns[(size_t)band].getVersion(); }
+    //bumped on every change to any of a band's params, including ones that don't redesign it
+    uint32_t getBandVersion(int band) const { return bandVersions[(size_t)band].load(std::memory_order_acquire); }
+    BiquadCoeffs makeCoefficients(const FilterUpdateReq& req, double sampleRate) const;
+    SvfCoeffs makeSvfCoefficients(const FilterUpdateReq& req, double sampleRate) const;
+    static BiquadCoeffs designBand(double sampleRate, int type, double freq, double gainDb, double quality, bool matched = false);
+    static SvfCoeffs designSvfBand(double sampleRate, int type, double freq, double gainDb, double quality, bool matched = false);
+    static int getTailSamples(const BandDesign& design, double sampleRate);
+    //rate the bands are designed and run at, the host's times the oversampling factor
+    double getDesignSampleRate() const { return lastSampleRate * (1 << oversamplingOrder.load()); }
+    double getHostSampleRate() const { return lastSampleRate; }
+
+    //taps of the linear phase kernel for the current choice and rate, 0 when it's off
+    int getLinearPhaseLength() const;
+    static int getLinearPhaseLength(int choice, double sampleRate);
+    int getLinearPhasePartitionSize() const { return linearPhasePartitionSize << getRateMultiple(lastSampleRate); }
+    //the builder's way in, under its lock. The convolver is fitted to a length before its
+    //kernels are posted, false while the audio thread still holds it. A kernel length of 0
+    //hands the bands back to the filters
+    bool sizeLinearPhaseConvolver(int length);
+    void setLinearPhaseKernel(const float* kernel, int length);
+    LinearPhaseBuilder* getLinearPhaseBuilder() { return linearPhaseBuilder.get(); }
+    //latency of the path the audio thread is on, the host is told on the message thread after
+    int getRunningLatencySamples() const { return runningLatency.load(std::memory_order_relaxed); }
+    bool usesParallelStructure() const { return filterStructureParam && *filterStructureParam >= 0.5f; }
+    //the parallel form builder's way in, under its lock
+    void setParallelDesign(const ParallelDesign& design) { parallelMailbox.write(design); }
+    ParallelFormBuilder* getParallelFormBuilder() { return parallelFormBuilder.get(); }
+
+    static constexpr float silenceThreshold = 6.0e-8f;  //-144 dB, under the last bit of 24 bit audio
+    static constexpr double tailDecayDb = -120.0;
+    static constexpr double maxTailSeconds = 10.0;    //what an unstable or marginal band reports
+    static constexpr int linearPhasePartitionSize = 512;    //at 44.1 and 48 kHz
+    static constexpr int drainIntervalMs = 20;  //how often the message thread designs automated bands and checks the latency
     
 private:
     void parameterChanged(const juce::String& parameterID, float newValue) override;
+    void timerCallback() override;
     void updateGain(int id);
+    static bool changesSignal(const FilterUpdateReq& req);
+    static bool affectsDesign(const FilterUpdateReq& req, int field);
+    static SectionKind getSectionKind(int type, bool matched);
+    void updateFilter(int ind, const FilterUpdateReq& req);
+    bool usesMatchedDesign() const { return filterDesignParam && *filterDesignParam >= 0.5f; }
+    template <typename SampleType>
+    void process(juce::AudioBuffer<SampleType>& buffer, FilterEngines<SampleType>& engines);
+    template <typename SampleType>
+    void pushToAnalyser(const juce::AudioBuffer<SampleType>& buffer, int startSample, int numSamples);
+    template <typename SampleType>
+    static bool isSilent(const juce::dsp::AudioBlock<SampleType>& block);
+    //designs go to both precisions
+    template <typename Fn>
+    void forEachEngine(Fn&& fn) { fn(floatEngines); fn(doubleEngines); }
+    void setOversampling(int order);
+    int getRunningLatency() const;
+    //doublings of the rate above 48 kHz, the linear phase sizes scale with it
+    static int getRateMultiple(double sampleRate);
+    double getRunningDesignRate() const { return spec.sampleRate * (1 << runningOrder); }
+    void applyDesign(int band, const BandDesign& design, bool smoothing);
+    void advanceRamps(int numSamples);
+    void finishRamp(int band);
+
+    //band is -1 for the pre/post gains, field is then 0 for pre and 1 for post. Field 6 of
+    //a band is its engine, which lives in engineParams rather than params
+    struct ParamSlot {
+        int band = -1;
+        int field = 0;
+    };
+    std::unordered_map<juce::String, ParamSlot> paramSlots;
 
     juce::dsp::ProcessSpec spec;
-    double lastSampleRate = 44100.0;
+    std::atomic<double> lastSampleRate{ 44100.0 };
     std::unique_ptr<AnalyserFifo<float>> analyserFifo;
+    std::array<int, MAX_CHANNELS> analyserChannels{};  //channels that go into the analyser downmix
+    int numAnalyserChannels = 0;
+    juce::AudioBuffer<float> analyserScratch;   //float copy of a sub-block for the analyser on the double path
     std::array<FilterUpdateReq, MAX_EQS> pendingUpdates;
-    juce::dsp::Gain<float> preGain;
-    juce::dsp::Gain<float> postGain;
+    std::array<TripleBuffer<BandDesign>, MAX_EQS> bandMailboxes;
+    std::array<SeqLock<BandDesign>, MAX_EQS> guiDesigns;
+    std::array<std::atomic<uint32_t>, MAX_EQS> bandVersions{};
+    std::atomic<uint32_t> dirtyBands{ 0 };  //bit per band whose params moved since the last drain
+    juce::SpinLock drainLock;   //one drain at a time, it's the only thing that posts bands
+    std::atomic<uint32_t> designGeneration{ 0 };
+    TripleBuffer<ParallelDesign> parallelMailbox;
+    ParallelDesign parallelDesign;  //audio thread's copy
+    bool runningParallel = false;   //audio thread only
+    bool requestedParallel = false; //audio thread only, the structure as of the last block
+    uint32_t parallelRequestGeneration = 0;  //design generation when parallel was last selected
+    std::array<BandRamp, MAX_EQS> bandRamps;   //audio thread only
+    std::array<BandDesign, MAX_EQS> postedDesigns;  //audio thread's copy of the newest design for each band
+    uint32_t unappliedBands = 0;    //audio thread only, bit per band whose posted design is for another rate
+    float rampTimeMs = -1.0f;
+    int numRamping = 0;
+    std::array<int, MAX_EQS> bandTailSamples{};    //audio thread's tail for each band's current design
+    int64_t silentSamples = 0;  //since the input last went above silenceThreshold
+    bool idle = false;
+    std::atomic<int> oversamplingOrder{ 0 };   //0 off, 1 2x, 2 4x, 3 8x
+    std::array<int, MAX_OVERSAMPLING_ORDER + 1> oversamplingLatency{};
+    int runningOrder = 0;   //audio thread's copy
+    PartitionedConvolver linearPhaseConvolver;  //shared by both precisions, only one runs. Empty while off
+    juce::dsp::ProcessSpec convolverSpec{};     //what the builder sizes it for, under its lock
+    std::atomic<int> linearPhaseKernelLength{ 0 };  //of the last kernel posted, 0 while off
+    std::atomic<bool> convolverInUse{ false };  //audio thread's, set while a block may run the convolver
+    std::atomic<bool> convolverResetRequested{ false };
+    bool runningLinearPhase = false;    //audio thread only
+    std::atomic<int> runningLatency{ 0 };   //of what the audio thread runs, reported to the host from the message thread
+    std::atomic<float> preGain{ 1.0f };   //linear, applied inside the cascade
+    std::atomic<float> postGain{ 1.0f };
+    juce::SharedResourcePointer<SharedBuilderThread> builderThread;  //outlives the builders below
+    std::unique_ptr<LinearPhaseBuilder> linearPhaseBuilder;
+    std::unique_ptr<ParallelFormBuilder> parallelFormBuilder;
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProceduralEqAudioProcessor)
 };
@@ -0,0 +1,159 @@
+/*
+  ==============================================================================
+
+    ResponseEvaluator.cpp
+    Created: 16 Oct 2026 3:05:21pm
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#include "ResponseEvaluator.h"
+#include "FastMath.h"
+
+bool ResponseEvaluator::prepare(int newNumPoints, double minFreq, double maxFreq, double sampleRate) {
+    jassert(newNumPoints > 0 && minFreq > 0.0 && maxFreq >= minFreq && sampleRate > 0.0);
+    if (newNumPoints == numPoints && minFreq == gridMin && maxFreq == gridMax && sampleRate == gridSampleRate)
+        return false;
+
+    numPoints = newNumPoints;
+    gridMin = minFreq;
+    gridMax = maxFreq;
+    gridSampleRate = sampleRate;
+
+    const auto numRegisters = ((size_t)numPoints + lanes - 1) / lanes;
+    numPadded = numRegisters * lanes;
+    frequencies.resize((size_t)numPoints);
+    laneStorage.assign(numLaneArrays * numPadded + lanes, 0.0);
+    floatStorage.assign(numFloatArrays * numPadded, 0.0f);
+
+    //fromRawArray loads whole registers, so the tables are built in SIMD aligned scratch.
+    //numPadded is a whole number of registers, which keeps every table's start aligned
+    std::vector<double> rawStorage(7 * numPadded + lanes, 0.0);
+    auto* rawTables = Register::getNextSIMDAlignedPtr(rawStorage.data());
+    double* raw[7];
+    for (size_t t = 0; t < 7; ++t)
+        raw[t] = rawTables + t * numPadded;
+
+    for (size_t i = 0; i < numPadded; ++i) {
+        //padding repeats the last point so it stays well defined
+        const auto point = juce::jmin(i, (size_t)numPoints - 1);
+        const auto freq = (double)FastMath::mapToLog10(float(point) / float(juce::jmax(1, numPoints - 1)), (float)minFreq, (float)maxFreq);
+        if (i < (size_t)numPoints)
+            frequencies[i] = freq;
+
+        const auto w = juce::MathConstants<double>::twoPi * freq / sampleRate;
+        double s, c;
+        FastMath::sinCos(0.5 * w, s, c);
+        raw[1][i] = s * s;
+        raw[0][i] = 1.0 - raw[1][i];
+        raw[2][i] = 4.0 * raw[0][i] * raw[1][i];
+        FastMath::sinCos(w, raw[4][i], raw[3][i]);
+        FastMath::sinCos(2.0 * w, raw[6][i], raw[5][i]);
+    }
+
+    std::vector<Register>* tables[7]{ &phi0, &phi1, &phi2, &cos1, &sin1, &cos2, &sin2 };
+    for (int t = 0; t < 7; ++t) {
+        tables[t]->resize(numRegisters);
+        for (size_t r = 0; r < numRegisters; ++r)
+            (*tables[t])[r] = Register::fromRawArray(raw[t] + r * lanes);
+    }
+    return true;
+}
+
+double* ResponseEvaluator::getLanes(LaneArray which) const {
+    return Register::getNextSIMDAlignedPtr(laneStorage.data()) + which * numPadded;
+}
+
+void ResponseEvaluator::evaluate(const BiquadCoeffs* sections, int numSections, float* magnitudeDb, float* phase, float* groupDelay) const {
+    jassert(numPoints > 0);
+
+    //|H|^2 = (B0 phi0 + B1 phi1 + B2 phi2) / (A0 phi0 + A1 phi1 + A2 phi2) stays accurate
+    //at low frequencies where 1 + a1 cos(w) + a2 cos(2w) would cancel
+    struct SquaredTerms { double B0, B1, B2, A0, A1, A2; };
+    std::array<SquaredTerms, 32> terms;
+    jassert(numSections <= (int)terms.size());
+    numSections = juce::jmin(numSections, (int)terms.size());
+    for (int k = 0; k < numSections; ++k) {
+        const auto& c = sections[k];
+        terms[(size_t)k] = { (c.b0 + c.b1 + c.b2) * (c.b0 + c.b1 + c.b2), (c.b0 - c.b1 + c.b2) * (c.b0 - c.b1 + c.b2), -4.0 * c.b0 * c.b2,
+                             (1.0 + c.a1 + c.a2) * (1.0 + c.a1 + c.a2), (1.0 - c.a1 + c.a2) * (1.0 - c.a1 + c.a2), -4.0 * c.a2 };
+    }
+
+    const bool wantsPhase = phase != nullptr || groupDelay != nullptr;
+    const int n = (int)numPadded;
+    auto* num = getLanes(numerator);
+    auto* den = getLanes(denominator);
+    auto* re = getLanes(crossRe);
+    auto* im = getLanes(crossIm);
+    auto* bm = getLanes(bMag);
+    auto* am = getLanes(aMag);
+    auto* bd = getLanes(bDelay);
+    auto* ad = getLanes(aDelay);
+    auto* delays = getLanes(delaySum);
+    auto* ratios = getFloats(ratio);
+    auto* ys = getFloats(crossY);
+    auto* xs = getFloats(crossX);
+    auto* dbs = getFloats(dbSum);
+    auto* phases = getFloats(phaseSum);
+    std::fill(dbs, dbs + n, 0.0f);
+    std::fill(phases, phases + n, 0.0f);
+    std::fill(delays, delays + n, 0.0);
+
+    for (int k = 0; k < numSections; ++k) {
+        const auto& t = terms[(size_t)k];
+        const auto& c = sections[k];
+        for (size_t r = 0; r < phi0.size(); ++r) {
+            const auto p0 = phi0[r], p1 = phi1[r], p2 = phi2[r];
+            (p0 * t.B0 + p1 * t.B1 + p2 * t.B2).copyToRawArray(num + r * lanes);
+            (p0 * t.A0 + p1 * t.A1 + p2 * t.A2).copyToRawArray(den + r * lanes);
+
+            if (wantsPhase) {
+                const auto c1 = cos1[r], s1 = sin1[r], c2 = cos2[r], s2 = sin2[r];
+                //B(e^jw) = Br + j Bi with e^-jw, and the k-weighted sums for the group delay
+                const auto br = c1 * c.b1 + c2 * c.b2 + c.b0;
+                const auto bi = (s1 * c.b1 + s2 * c.b2) * -1.0;
+                const auto dbr = c1 * c.b1 + c2 * (2.0 * c.b2);
+                const auto dbi = (s1 * c.b1 + s2 * (2.0 * c.b2)) * -1.0;
+                const auto ar = c1 * c.a1 + c2 * c.a2 + 1.0;
+                const auto ai = (s1 * c.a1 + s2 * c.a2) * -1.0;
+                const auto dar = c1 * c.a1 + c2 * (2.0 * c.a2);
+                const auto dai = (s1 * c.a1 + s2 * (2.0 * c.a2)) * -1.0;
+
+                //arg(B) - arg(A) is arg(B conj(A)), one atan2 per section instead of two
+                (br * ar + bi * ai).copyToRawArray(re + r * lanes);
+                (bi * ar - br * ai).copyToRawArray(im + r * lanes);
+                //tau = Re(sum k p_k e^-jkw / P) for numerator minus denominator
+                (br * br + bi * bi).copyToRawArray(bm + r * lanes);
+                (ar * ar + ai * ai).copyToRawArray(am + r * lanes);
+                (dbr * br + dbi * bi).copyToRawArray(bd + r * lanes);
+                (dar * ar + dai * ai).copyToRawArray(ad + r * lanes);
+            }
+        }
+
+        //the -100 dB floor is well inside float range, so the ratio can go through the float log
+        for (int i = 0; i < n; ++i)
+            ratios[i] = (float)juce::jlimit(1.0e-12, 1.0e12, std::max(num[i], 1.0e-30) / std::max(den[i], 1.0e-30));
+        FastMath::powerToDecibels(ratios, ratios, n, -100.0f);
+        juce::FloatVectorOperations::add(dbs, ratios, n);
+
+        if (wantsPhase) {
+            for (int i = 0; i < n; ++i) {
+                ys[i] = (float)im[i];
+                xs[i] = (float)re[i];
+                delays[i] += (bm[i] > 0.0 ? bd[i] / bm[i] : 0.0) - (am[i] > 0.0 ? ad[i] / am[i] : 0.0);
+            }
+            FastMath::atan2(ys, ys, xs, n);
+            juce::FloatVectorOperations::add(phases, ys, n);
+        }
+    }
+
+    if (magnitudeDb != nullptr)
+        std::copy(dbs, dbs + numPoints, magnitudeDb);
+    if (phase != nullptr)
+        for (int i = 0; i < numPoints; ++i)
+            phase[i] = std::remainder(phases[i], juce::MathConstants<float>::twoPi);
+    if (groupDelay != nullptr)
+        for (int i = 0; i < numPoints; ++i)
+            groupDelay[i] = (float)delays[i];
+}
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    ResponseEvaluator.h
+    Created: 16 Oct 2026 3:05:21pm
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "FilterDesign.h"
+
+//==============================================================================
+/**
+*/
+//Evaluates biquad responses over a fixed log frequency grid. The e^-jw and e^-2jw
+//phasors (and the sin^2(w/2) terms the magnitude is computed from) are built once
+//per grid size and sample rate, after that each point is a handful of multiplies.
+//Each section's polynomials are evaluated a SIMD register of points at a time into
+//scratch arrays, then the divisions, FastMath's log and atan2 run over whole arrays
+//so they vectorize too. Phase and group delay come out of the same pass on request.
+class ResponseEvaluator {
+public:
+    using Register = juce::dsp::SIMDRegister<double>;
+    static constexpr size_t lanes = Register::SIMDNumElements;
+
+    //log spaced grid from minFreq to maxFreq (a single point sits at minFreq), returns
+    //false if nothing had to be rebuilt
+    bool prepare(int numPoints, double minFreq, double maxFreq, double sampleRate);
+
+    int getNumPoints() const { return numPoints; }
+    double getSampleRate() const { return gridSampleRate; }
+    double getFrequency(int index) const { return frequencies[(size_t)index]; }
+    const double* getFrequencies() const { return frequencies.data(); }
+
+    //how far evaluate's float logs, atan2s and sums may stray from a std::complex evaluation
+    //in double, for up to 12 sections anywhere in the plugin's range. ResponseEvaluatorBenchmark
+    //--check holds it to these
+    static constexpr double maxMagnitudeErrorDb = 1.0e-3;
+    static constexpr double maxPhaseError = 5.0e-5;         //radians
+    static constexpr double maxGroupDelayError = 1.0e-5;    //samples, relative above 1 sample
+
+    //combined response of numSections biquads. Magnitude is in dB (each section floored
+    //at -100 dB), phase in radians and group delay in samples. Pass nullptr for any
+    //output that isn't needed, phase and group delay cost extra. Works in the evaluator's
+    //scratch, so one thread at a time
+    void evaluate(const BiquadCoeffs* sections, int numSections, float* magnitudeDb,
+                  float* phase = nullptr, float* groupDelay = nullptr) const;
+
+    void evaluate(const BiquadCoeffs& section, float* magnitudeDb, float* phase = nullptr, float* groupDelay = nullptr) const {
+        evaluate(&section, 1, magnitudeDb, phase, groupDelay);
+    }
+
+private:
+    int numPoints = 0;
+    double gridMin = 0.0, gridMax = 0.0, gridSampleRate = 0.0;
+
+    std::vector<double> frequencies;
+    //structure of arrays, padded to a whole number of registers
+    std::vector<Register> phi0, phi1, phi2;
+    std::vector<Register> cos1, sin1, cos2, sin2;
+
+    //evaluate's per point working arrays, sized in prepare. The lanes are SIMD aligned
+    enum LaneArray { numerator, denominator, crossRe, crossIm, bMag, aMag, bDelay, aDelay, delaySum, numLaneArrays };
+    enum FloatArray { ratio, crossY, crossX, dbSum, phaseSum, numFloatArrays };
+    mutable std::vector<double> laneStorage;
+    mutable std::vector<float> floatStorage;
+    size_t numPadded = 0;
+    double* getLanes(LaneArray which) const;
+    float* getFloats(FloatArray which) const { return floatStorage.data() + which * numPadded; }
+};
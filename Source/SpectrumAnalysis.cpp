@@ -0,0 +1,173 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalysis.cpp
+    Created: 16 Oct 2026 1:14:50pm
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#include "SpectrumAnalysis.h"
+#include "PluginProcessor.h"
+
+static constexpr float mindB = -100.0f;
+static constexpr float maxdB = 24.0f;
+static constexpr double minFreq = 20.0;
+static constexpr double maxFreq = 20000.0;
+
+SpectrumWorker::SpectrumWorker(ProceduralEqAudioProcessor& p) : juce::Thread("Spectrum Analysis"), audioProcessor(p),
+                               forwardFFT(fftOrder), window(fftSize, juce::dsp::WindowingFunction<float>::hann) {
+    frame.assign(fftSize, 0.0f);
+    scratch.assign(fftSize, 0.0f);
+    fftData.assign(2 * fftSize, 0.0f);
+    averagedPower.assign(fftSize / 2 + 1, 0.0f);
+    binMap.resize(scopeSize);
+    pointPower.assign(scopeSize, 0.0f);
+    startThread(juce::Thread::Priority::low);
+}
+
+SpectrumWorker::~SpectrumWorker() {
+    stopThread(1000);
+}
+
+//50% or 75% overlap, but never more FFTs per second than the budget allows
+int SpectrumWorker::getHopSize(double sampleRate) const {
+    const bool quarterHop = audioProcessor.analyserOverlapParam && *audioProcessor.analyserOverlapParam >= 0.5f;
+    const int hop = quarterHop ? fftSize / 4 : fftSize / 2;
+    const int minHop = (int)std::ceil(sampleRate / maxFramesPerSecond);
+    return juce::jlimit(1, (int)fftSize, juce::jmax(hop, minHop));
+}
+
+void SpectrumWorker::updateWindow() {
+    const int choice = audioProcessor.analyserWindowParam ? (int)*audioProcessor.analyserWindowParam : 0;
+    if (choice == currentWindow)
+        return;
+
+    using Window = juce::dsp::WindowingFunction<float>;
+    static constexpr Window::WindowingMethod methods[]{ Window::hann, Window::hamming, Window::blackman, Window::blackmanHarris, Window::flatTop };
+    currentWindow = juce::jlimit(0, (int)std::size(methods) - 1, choice);
+    window.fillWindowingTables(fftSize, methods[currentWindow]);
+}
+
+//only rebuilt when the sample rate or smoothing changes, the per frame work is then a table walk
+void SpectrumWorker::updateBinMap(double sampleRate) {
+    const int smoothing = audioProcessor.analyserSmoothingParam ? (int)*audioProcessor.analyserSmoothingParam : 0;
+    if (sampleRate == mappedSampleRate && smoothing == mappedSmoothing)
+        return;
+
+    mappedSampleRate = sampleRate;
+    mappedSmoothing = smoothing;
+
+    //Off, 1/24, 1/12, 1/6 and 1/3 octave
+    static constexpr double fractions[]{ 0.0, 1.0 / 24.0, 1.0 / 12.0, 1.0 / 6.0, 1.0 / 3.0 };
+    const double octaves = fractions[juce::jlimit(0, (int)std::size(fractions) - 1, smoothing)];
+    const double binWidth = sampleRate / fftSize;
+    const int lastBin = fftSize / 2;
+    const double pointRatio = std::pow(maxFreq / minFreq, 1.0 / (scopeSize - 1));
+
+    for (int i = 0; i < scopeSize; ++i) {
+        const double centre = minFreq * std::pow(pointRatio, (double)i);
+        //half way (geometrically) to the neighbouring points, or the smoothing width if wider
+        const double halfWidth = juce::jmax(std::sqrt(pointRatio), std::pow(2.0, octaves * 0.5));
+        const int start = juce::jlimit(0, lastBin, (int)std::ceil(centre / halfWidth / binWidth));
+        const int end = juce::jlimit(0, lastBin + 1, (int)std::floor(centre * halfWidth / binWidth) + 1);
+
+        auto& range = binMap[(size_t)i];
+        if (end - start >= 1) {
+            range = { start, end, 0.0f };
+        }
+        else {
+            const double exactBin = juce::jmin(centre / binWidth, (double)lastBin);
+            const int below = juce::jmin((int)exactBin, lastBin - 1);
+            range = { below, below, (float)(exactBin - below) };
+        }
+    }
+}
+
+void SpectrumWorker::run() {
+    while (!threadShouldExit()) {
+        auto* fifo = audioProcessor.getAnalyserFifo();
+        auto sampleRate = audioProcessor.getSampleRate();
+        if (sampleRate <= 0.0)
+            sampleRate = 44100.0;
+        const int hop = getHopSize(sampleRate);
+
+        //prepareToPlay asked for a fresh start, what's in the frame is from before it
+        if (fifo != nullptr && fifo->skipIfResetRequested())
+            std::fill(frame.begin(), frame.end(), 0.0f);
+
+        if (fifo == nullptr || fifo->getNumReady() < hop) {
+            //sleep for about half a hop, short enough to keep up and long enough to stay cheap
+            wait(juce::jlimit(1, 20, (int)(500.0 * hop / sampleRate)));
+            continue;
+        }
+
+        //if we fell behind, skip straight to the newest full frame rather than
+        //spending time on frames nobody will see
+        const int backlog = fifo->getNumReady();
+        if (backlog > fftSize + hop) {
+            const int toSkip = (backlog - fftSize) / hop * hop;
+            for (int skipped = 0; skipped < toSkip;)
+                skipped += fifo->pop(scratch.data(), juce::jmin((int)fftSize, toSkip - skipped));
+        }
+
+        const int numRead = fifo->pop(scratch.data(), hop);
+        std::memmove(frame.data(), frame.data() + numRead, sizeof(float) * (size_t)(fftSize - numRead));
+        std::memcpy(frame.data() + fftSize - numRead, scratch.data(), sizeof(float) * (size_t)numRead);
+
+        updateWindow();
+        updateBinMap(sampleRate);
+        analyseFrame(hop, sampleRate);
+        frames.write(output);
+    }
+}
+
+void SpectrumWorker::analyseFrame(int hop, double sampleRate) {
+    std::copy(frame.begin(), frame.end(), fftData.begin());
+    std::fill(fftData.begin() + fftSize, fftData.end(), 0.0f);
+    window.multiplyWithWindowingTable(fftData.data(), fftSize);
+    forwardFFT.performFrequencyOnlyForwardTransform(fftData.data());
+
+    //one pole average of the power per bin, the time constant is in ms of audio
+    const float tauMs = audioProcessor.analyserAveragingParam ? audioProcessor.analyserAveragingParam->load() : 0.0f;
+    const float alpha = tauMs <= 0.0f ? 1.0f : 1.0f - FastMath::exp(-(float)(hop * 1000.0 / sampleRate) / tauMs);
+    for (size_t bin = 0; bin < averagedPower.size(); ++bin) {
+        const auto power = fftData[bin] * fftData[bin];
+        averagedPower[bin] += alpha * (power - averagedPower[bin]);
+    }
+
+    const bool useMax = audioProcessor.analyserBinModeParam && *audioProcessor.analyserBinModeParam >= 0.5f;
+    for (size_t i = 0; i < binMap.size(); ++i) {
+        const auto& range = binMap[i];
+        float power;
+        if (range.end == range.start) {
+            power = averagedPower[(size_t)range.start] + range.frac * (averagedPower[(size_t)range.start + 1] - averagedPower[(size_t)range.start]);
+        }
+        else if (useMax) {
+            power = *std::max_element(averagedPower.begin() + range.start, averagedPower.begin() + range.end);
+        }
+        else {
+            power = std::accumulate(averagedPower.begin() + range.start, averagedPower.begin() + range.end, 0.0f) / (float)(range.end - range.start);
+        }
+        pointPower[i] = juce::jmax(power, 1.0e-20f);
+    }
+
+    //10 * log10(power), then shifted, scaled and clipped into 0..1 over the whole frame at once
+    FastMath::powerToDecibels(pointPower.data(), pointPower.data(), scopeSize, -200.0f);
+    juce::FloatVectorOperations::multiply(pointPower.data(), 1.0f / (maxdB - mindB), scopeSize);
+    juce::FloatVectorOperations::add(pointPower.data(), -(maxdB + mindB) / (maxdB - mindB), scopeSize);
+    juce::FloatVectorOperations::clip(output.level.data(), pointPower.data(), 0.0f, 1.0f, scopeSize);
+
+    //peaks fall back at a fixed dB per second and get pushed up by anything louder
+    output.hasPeak = audioProcessor.analyserPeakHoldParam && *audioProcessor.analyserPeakHoldParam >= 0.5f;
+    if (output.hasPeak) {
+        const float decaydBPerSecond = audioProcessor.analyserPeakDecayParam ? audioProcessor.analyserPeakDecayParam->load() : 12.0f;
+        const float fall = decaydBPerSecond * (float)(hop / sampleRate) / (maxdB - mindB);
+        for (size_t i = 0; i < output.peak.size(); ++i)
+            output.peak[i] = juce::jmax(output.level[i], output.peak[i] - fall);
+    }
+    else {
+        output.peak = output.level;
+    }
+}
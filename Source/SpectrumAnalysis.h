@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    SpectrumAnalysis.h
+    Created: 16 Oct 2026 1:14:50pm
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+#pragma once
+#include <JuceHeader.h>
+#include "LockFree.h"
+
+class ProceduralEqAudioProcessor;
+
+enum {
+    fftOrder = 11,
+    fftSize = 1 << fftOrder,
+    scopeSize = 512
+};
+
+using ScopeFrame = std::array<float, scopeSize>;
+
+//what the worker posts per analysis frame, levels are normalised 0 to 1 for drawing
+struct AnalyserFrame {
+    ScopeFrame level{};
+    ScopeFrame peak{};
+    bool hasPeak = false;
+};
+
+//==============================================================================
+/**
+*/
+//Background thread that drains the processor's analyser FIFO, runs overlapping
+//windowed FFTs every hop and posts finished, ready to draw frames. The message
+//thread only has to pick up the latest frame and paint it.
+//Scope points are log spaced over 20 Hz to 20 kHz like the response curve, each
+//one fed by every bin inside its band (optionally widened to a fractional octave).
+//Overlap, window, exponential averaging and peak hold come from the analyser
+//parameters. The number of FFTs per second is capped at maxFramesPerSecond no
+//matter the sample rate or overlap, which keeps each instance's cost fixed.
+class SpectrumWorker : private juce::Thread {
+public:
+    SpectrumWorker(ProceduralEqAudioProcessor&);
+    ~SpectrumWorker() override;
+
+    static constexpr int maxFramesPerSecond = 120;
+
+    //copies the newest frame into dest, false if nothing new was posted since the last call
+    bool getLatestFrame(AnalyserFrame& dest) { return frames.read(dest); }
+
+private:
+    void run() override;
+    int getHopSize(double sampleRate) const;
+    void updateWindow();
+    void updateBinMap(double sampleRate);
+    void analyseFrame(int hop, double sampleRate);
+
+    //bins feeding one scope point. Points narrower than a bin interpolate
+    //between start and start + 1 by frac instead of aggregating
+    struct BinRange {
+        int start = 0;
+        int end = 0;
+        float frac = 0.0f;
+    };
+
+    ProceduralEqAudioProcessor& audioProcessor;
+    juce::dsp::FFT forwardFFT;
+    juce::dsp::WindowingFunction<float> window;
+    int currentWindow = 0;
+
+    std::vector<float> frame;   //last fftSize samples, oldest first
+    std::vector<float> scratch;
+    std::vector<float> fftData;
+    std::vector<float> averagedPower;
+    std::vector<BinRange> binMap;
+    std::vector<float> pointPower;
+    double mappedSampleRate = 0.0;
+    int mappedSmoothing = -1;
+    AnalyserFrame output;
+    TripleBuffer<AnalyserFrame> frames;
+};
@@ -0,0 +1,468 @@
+/*
+  ==============================================================================
+
+    BatchRender.cpp
+    Created: 16 Oct 2026 5:02:48pm
+    Author:  Cody
+
+  ==============================================================================
+*/
+
+//Offline renderer for batch mastering. Loads a state blob saved by the plugin
+//(getStateInformation, i.e. the parameter ValueTree) and streams every input file
+//through its own copy of the eq, writing the result into the output folder under
+//the same name. Subfolders of a searched folder are recreated under the output folder,
+//so stems that share a name in different folders don't overwrite each other.
+//
+//  BatchRender --state=master.eqstate --output=rendered [--threads=8] [--block=8192]
+//              [--format=wav|aiff|flac] [--bits=24] [--overwrite] stems/ kick.wav ...
+//  BatchRender --check
+//
+//Folders are searched recursively for wav/aiff/flac. Inputs that would still land on
+//the same output are refused before anything renders. Files are shared out over a
+//thread pool with one processor instance per worker, and each worker reports how
+//many samples per second its core got through. Each file is written next to its output
+//under a temporary name and only moved over the output once it has rendered in full, so
+//a failed or cancelled render never leaves a truncated file or loses the old one.
+//
+//--check renders a mono, a 20 channel, a stereo and a 5.1 file of noise through one
+//worker with the default state. It exits non-zero unless the 20 channel file alone is
+//refused and the others come back with their channel count, length and finite samples.
+
+#include <JuceHeader.h>
+#include "../Source/PluginProcessor.h"
+
+namespace {
+
+const juce::String audioWildcard{ "*.wav;*.aif;*.aiff;*.flac" };
+
+struct Options {
+    juce::File stateFile;
+    juce::File outputFolder;
+    juce::Array<juce::File> inputs;
+    juce::Array<juce::File> outputs;    //one per input
+    juce::String format;    //empty keeps the input's format
+    int bitDepth = 0;       //0 keeps the input's bit depth
+    int blockSize = 8192;
+    int numThreads = juce::SystemStats::getNumCpus();
+    bool overwrite = false;
+};
+
+struct WorkerStats {
+    int filesDone = 0;
+    int filesFailed = 0;
+    int64_t frames = 0;
+    int64_t channelSamples = 0;
+    double dspSeconds = 0.0;    //time inside processBlock
+    double totalSeconds = 0.0;  //including decoding and encoding
+};
+
+void printUsage() {
+    std::cout << "usage: BatchRender --state=file --output=folder [--threads=N] [--block=8192]\n"
+                 "                   [--format=wav|aiff|flac] [--bits=16|24|32] [--overwrite] inputs...\n"
+                 "       BatchRender --check\n";
+}
+
+juce::String getFormatExtension(const Options& options, const juce::File& input) {
+    if (options.format == "aiff") return ".aiff";
+    if (options.format == "flac") return ".flac";
+    if (options.format == "wav")  return ".wav";
+    return input.getFileExtension();
+}
+
+//subfolder is the input's folder relative to the folder it was found in, empty for files given directly
+juce::File getOutputFile(const Options& options, const juce::File& input, const juce::String& subfolder) {
+    const auto folder = subfolder.isEmpty() ? options.outputFolder : options.outputFolder.getChildFile(subfolder);
+    return folder.getChildFile(input.getFileNameWithoutExtension() + getFormatExtension(options, input));
+}
+
+bool parseOptions(const juce::ArgumentList& args, Options& options) {
+    if (args.containsOption("--help|-h") || !args.containsOption("--state") || !args.containsOption("--output")) {
+        printUsage();
+        return false;
+    }
+
+    const auto cwd = juce::File::getCurrentWorkingDirectory();
+    options.stateFile = cwd.getChildFile(args.getValueForOption("--state"));
+    options.outputFolder = cwd.getChildFile(args.getValueForOption("--output"));
+    if (args.containsOption("--threads")) options.numThreads = args.getValueForOption("--threads").getIntValue();
+    if (args.containsOption("--block"))   options.blockSize = args.getValueForOption("--block").getIntValue();
+    if (args.containsOption("--bits"))    options.bitDepth = args.getValueForOption("--bits").getIntValue();
+    if (args.containsOption("--format"))  options.format = args.getValueForOption("--format").toLowerCase();
+    options.overwrite = args.containsOption("--overwrite");
+
+    options.numThreads = juce::jlimit(1, 256, options.numThreads);
+    options.blockSize = juce::jlimit(32, 1 << 20, options.blockSize);
+
+    if (!options.stateFile.existsAsFile()) {
+        std::cerr << "state file not found: " << options.stateFile.getFullPathName() << "\n";
+        return false;
+    }
+    if (options.format.isNotEmpty() && options.format != "wav" && options.format != "aiff" && options.format != "flac") {
+        std::cerr << "unknown format: " << options.format << "\n";
+        return false;
+    }
+
+    for (auto& arg : args.arguments) {
+        if (arg.isOption())
+            continue;
+
+        auto file = cwd.getChildFile(arg.text);
+        if (file.isDirectory()) {
+            for (auto& entry : juce::RangedDirectoryIterator(file, true, audioWildcard, juce::File::findFiles)) {
+                const auto relative = entry.getFile().getParentDirectory().getRelativePathFrom(file);
+                options.inputs.add(entry.getFile());
+                options.outputs.add(getOutputFile(options, entry.getFile(), relative == "." ? juce::String() : relative));
+            }
+        }
+        else if (file.existsAsFile()) {
+            options.inputs.add(file);
+            options.outputs.add(getOutputFile(options, file, {}));
+        }
+        else {
+            std::cerr << "input not found: " << file.getFullPathName() << "\n";
+        }
+    }
+
+    if (options.inputs.isEmpty()) {
+        std::cerr << "no input files\n";
+        return false;
+    }
+
+    //workers run in parallel, two jobs writing one file would race, so that's caught here
+    std::map<juce::String, int> seen;
+    for (int i = 0; i < options.outputs.size(); ++i) {
+        const auto key = options.outputs.getReference(i).getFullPathName().toLowerCase();
+        const auto [it, added] = seen.emplace(key, i);
+        if (!added) {
+            std::cerr << options.inputs.getReference(it->second).getFullPathName() << " and "
+                      << options.inputs.getReference(i).getFullPathName() << " would both render to "
+                      << options.outputs.getReference(i).getFullPathName() << "\n";
+            return false;
+        }
+    }
+    return options.outputFolder.createDirectory().wasOk();
+}
+
+//==============================================================================
+/**
+*/
+//One per thread in the pool. Owns its own processor and pulls files off the shared
+//list until there are none left, so the number of processors is the number of threads
+//no matter how many files there are.
+struct RenderWorker : juce::ThreadPoolJob {
+    RenderWorker(int workerIndex, const Options& o, const juce::MemoryBlock& state, std::atomic<int>& next)
+        : juce::ThreadPoolJob("render " + juce::String(workerIndex)), options(o), nextFile(next) {
+        formats.registerBasicFormats();
+        processor.setStateInformation(state.getData(), (int)state.getSize());
+        //nobody is looking at the analyser offline
+        if (auto* analyserOn = processor.tree.getParameter("analyserOn"))
+            analyserOn->setValueNotifyingHost(0.0f);
+        buffer.setSize(2, options.blockSize);
+    }
+
+    JobStatus runJob() override {
+        const auto start = juce::Time::getMillisecondCounterHiRes();
+        for (int index = nextFile++; index < options.inputs.size() && !shouldExit(); index = nextFile++) {
+            juce::String error;
+            if (renderFile(options.inputs.getReference(index), options.outputs.getReference(index), error)) {
+                ++stats.filesDone;
+            }
+            else {
+                ++stats.filesFailed;
+                const juce::ScopedLock sl(getOutputLock());
+                std::cerr << options.inputs.getReference(index).getFullPathName() << ": " << error << "\n";
+            }
+        }
+        stats.totalSeconds = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+        return jobHasFinished;
+    }
+
+    static juce::CriticalSection& getOutputLock() {
+        static juce::CriticalSection lock;
+        return lock;
+    }
+
+    WorkerStats stats;
+
+private:
+    bool renderFile(const juce::File& input, const juce::File& output, juce::String& error) {
+        std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(input));
+        if (reader == nullptr) {
+            error = "can't read this file";
+            return false;
+        }
+
+        if (output == input) {
+            error = "output would replace the input";
+            return false;
+        }
+        if (output.exists() && !options.overwrite) {
+            error = "output already exists, use --overwrite to replace it";
+            return false;
+        }
+
+        auto* format = formats.findFormatForFileExtension(output.getFileExtension());
+        if (format == nullptr) {
+            error = "no writer for " + output.getFileExtension();
+            return false;
+        }
+
+        const auto numChannels = (int)reader->numChannels;
+        const auto sampleRate = reader->sampleRate;
+        juce::AudioProcessor::BusesLayout layout;
+        layout.inputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+        layout.outputBuses.add(juce::AudioChannelSet::canonicalChannelSet(numChannels));
+        const auto previousLayout = processor.getBusesLayout();
+        if (!processor.setBusesLayout(layout)) {
+            //setBusesLayout doesn't say how far it got before refusing, so the worker goes
+            //back to the last layout that rendered and the next file starts from there
+            processor.setBusesLayout(previousLayout);
+            error = juce::String(numChannels) + " channel files aren't supported";
+            return false;
+        }
+
+        auto bits = options.bitDepth > 0 ? options.bitDepth : (int)reader->bitsPerSample;
+        if (!format->getPossibleBitDepths().contains(bits))
+            bits = format->getPossibleBitDepths().contains(24) ? 24 : format->getPossibleBitDepths().getLast();
+
+        if (output.getParentDirectory().createDirectory().failed()) {
+            error = "can't create " + output.getParentDirectory().getFullPathName();
+            return false;
+        }
+        //rendered beside the output and moved over it at the end, the temporary is deleted
+        //with this scope if anything fails on the way
+        juce::TemporaryFile temp(output);
+        auto stream = temp.getFile().createOutputStream();
+        if (stream == nullptr) {
+            error = "can't create " + temp.getFile().getFullPathName();
+            return false;
+        }
+
+        std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate, (unsigned int)numChannels, bits, reader->metadataValues, 0));
+        if (writer == nullptr) {
+            error = "the " + format->getFormatName() + " writer refused this format";
+            return false;
+        }
+        stream.release(); //the writer owns it now
+
+        processor.setRateAndBufferSizeDetails(sampleRate, options.blockSize);
+        processor.prepareToPlay(sampleRate, options.blockSize);
+        processor.reset();
+
+        buffer.setSize(numChannels, options.blockSize, false, false, true);
+        juce::MidiBuffer midi;
+        const auto ticksPerSecond = (double)juce::Time::getHighResolutionTicksPerSecond();
+
+        //oversampling and linear phase delay the output, so the first latency samples out are
+        //dropped and latency samples of silence follow the input to flush the rest. The file
+        //comes out sample aligned with its source and the same length
+        const auto latency = (juce::int64)processor.getLatencySamples();
+        const auto length = reader->lengthInSamples;
+        for (juce::int64 pos = 0; pos < length + latency && !shouldExit(); pos += options.blockSize) {
+            const auto num = (int)juce::jmin((juce::int64)options.blockSize, length + latency - pos);
+            const auto numIn = (int)juce::jlimit((juce::int64)0, (juce::int64)num, length - pos);
+            buffer.setSize(numChannels, num, false, false, true);
+            if (numIn > 0)
+                reader->read(&buffer, 0, numIn, pos, true, true);
+            if (numIn < num)
+                buffer.clear(numIn, num - numIn);
+
+            const auto before = juce::Time::getHighResolutionTicks();
+            processor.processBlock(buffer, midi);
+            stats.dspSeconds += double(juce::Time::getHighResolutionTicks() - before) / ticksPerSecond;
+
+            const auto skip = (int)juce::jlimit((juce::int64)0, (juce::int64)num, latency - pos);
+            if (skip < num && !writer->writeFromAudioSampleBuffer(buffer, skip, num - skip)) {
+                error = "write failed";
+                break;
+            }
+            stats.frames += numIn;
+            stats.channelSamples += (int64_t)numIn * numChannels;
+        }
+
+        processor.releaseResources();
+        if (error.isEmpty() && shouldExit())
+            error = "cancelled";
+        if (error.isNotEmpty())
+            return false;
+
+        //the writer finishes the header and closes the file when it goes
+        writer.reset();
+        if (!temp.overwriteTargetFileWithTemporary()) {
+            error = "can't replace " + output.getFullPathName();
+            return false;
+        }
+        return true;
+    }
+
+    const Options& options;
+    std::atomic<int>& nextFile;
+    juce::AudioFormatManager formats;
+    ProceduralEqAudioProcessor processor;
+    juce::AudioBuffer<float> buffer;
+};
+
+//renders every input with one worker per thread and prints what each got through,
+//returns how many files failed
+int renderAll(const Options& options, const juce::MemoryBlock& state) {
+    const auto numWorkers = juce::jmin(options.numThreads, options.inputs.size());
+    std::atomic<int> nextFile{ 0 };
+
+    //processors are built here on the main thread and only used by their worker afterwards
+    juce::OwnedArray<RenderWorker> workers;
+    for (int i = 0; i < numWorkers; ++i)
+        workers.add(new RenderWorker(i, options, state, nextFile));
+
+    const auto start = juce::Time::getMillisecondCounterHiRes();
+    {
+        juce::ThreadPool pool(juce::ThreadPoolOptions{}.withThreadName("BatchRender").withNumberOfThreads(numWorkers));
+        for (auto* worker : workers)
+            pool.addJob(worker, false);
+        while (pool.getNumJobs() > 0)
+            juce::Thread::sleep(50);
+    }
+    const auto wallSeconds = (juce::Time::getMillisecondCounterHiRes() - start) * 0.001;
+
+    int done = 0, failed = 0;
+    int64_t totalSamples = 0;
+    for (int i = 0; i < workers.size(); ++i) {
+        const auto& s = workers[i]->stats;
+        done += s.filesDone;
+        failed += s.filesFailed;
+        totalSamples += s.channelSamples;
+        std::cout << "worker " << i << ": " << s.filesDone << " files, "
+                  << juce::String(s.dspSeconds > 0.0 ? double(s.channelSamples) / s.dspSeconds : 0.0, 0) << " samples/s in the eq, "
+                  << juce::String(s.totalSeconds > 0.0 ? double(s.channelSamples) / s.totalSeconds : 0.0, 0) << " samples/s with file io\n";
+    }
+    std::cout << done << " files rendered, " << failed << " failed, "
+              << juce::String(wallSeconds > 0.0 ? double(totalSamples) / wallSeconds : 0.0, 0) << " samples/s overall in "
+              << juce::String(wallSeconds, 2) << " s\n";
+    return failed;
+}
+
+bool writeNoise(const juce::File& file, int numChannels, double sampleRate, int length) {
+    juce::AudioBuffer<float> noise(numChannels, length);
+    juce::Random random(numChannels);
+    for (int ch = 0; ch < numChannels; ++ch)
+        for (int i = 0; i < length; ++i)
+            noise.setSample(ch, i, random.nextFloat() * 0.5f - 0.25f);
+
+    juce::WavAudioFormat wav;
+    std::unique_ptr<juce::OutputStream> stream(file.createOutputStream());
+    if (stream == nullptr)
+        return false;
+    std::unique_ptr<juce::AudioFormatWriter> writer(wav.createWriterFor(stream.get(), sampleRate, (unsigned int)numChannels, 24, {}, 0));
+    if (writer == nullptr)
+        return false;
+    stream.release(); //the writer owns it now
+    return writer->writeFromAudioSampleBuffer(noise, 0, length);
+}
+
+//the output has to match its input's channels, rate and length, with nothing but finite samples
+bool checkRendered(juce::AudioFormatManager& formats, const juce::File& input, const juce::File& output) {
+    std::unique_ptr<juce::AudioFormatReader> in(formats.createReaderFor(input));
+    std::unique_ptr<juce::AudioFormatReader> out(formats.createReaderFor(output));
+    if (in == nullptr || out == nullptr) {
+        std::cerr << "check: can't read " << output.getFullPathName() << "\n";
+        return false;
+    }
+    if (out->numChannels != in->numChannels || out->lengthInSamples != in->lengthInSamples || out->sampleRate != in->sampleRate) {
+        std::cerr << "check: " << output.getFileName() << " came back as " << (int)out->numChannels << " channels, "
+                  << out->lengthInSamples << " samples at " << out->sampleRate << " Hz, expected " << (int)in->numChannels
+                  << ", " << in->lengthInSamples << " at " << in->sampleRate << "\n";
+        return false;
+    }
+    juce::AudioBuffer<float> rendered((int)out->numChannels, (int)out->lengthInSamples);
+    out->read(&rendered, 0, rendered.getNumSamples(), 0, true, true);
+    for (int ch = 0; ch < rendered.getNumChannels(); ++ch) {
+        for (int i = 0; i < rendered.getNumSamples(); ++i) {
+            if (!std::isfinite(rendered.getSample(ch, i))) {
+                std::cerr << "check: " << output.getFileName() << " has a non-finite sample on channel " << ch << "\n";
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+//a mono, an unsupported 20 channel, a stereo and a 5.1 file through a single worker, so
+//the one processor has to switch layouts both ways and get past the refused file
+int runCheck() {
+    const auto folder = juce::File::getSpecialLocation(juce::File::tempDirectory).getNonexistentChildFile("BatchRenderCheck", {}, false);
+    Options options;
+    options.outputFolder = folder.getChildFile("rendered");
+    options.numThreads = 1;
+    if (folder.getChildFile("inputs").createDirectory().failed() || options.outputFolder.createDirectory().failed()) {
+        std::cerr << "check: can't create " << folder.getFullPathName() << "\n";
+        return 1;
+    }
+
+    const auto unsupported = MAX_CHANNELS + 4;
+    const int channelCounts[] = { 1, unsupported, 2, 6 };
+    for (auto numChannels : channelCounts) {
+        const auto input = folder.getChildFile("inputs").getChildFile(juce::String(numChannels) + "ch.wav");
+        if (!writeNoise(input, numChannels, 48000.0, 48000)) {
+            std::cerr << "check: can't write " << input.getFullPathName() << "\n";
+            folder.deleteRecursively();
+            return 1;
+        }
+        options.inputs.add(input);
+        options.outputs.add(getOutputFile(options, input, {}));
+    }
+
+    juce::MemoryBlock state;
+    {
+        ProceduralEqAudioProcessor defaults;
+        defaults.getStateInformation(state);
+    }
+
+    bool passed = renderAll(options, state) == 1;
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+    for (int i = 0; i < options.inputs.size(); ++i) {
+        const auto& output = options.outputs.getReference(i);
+        if (channelCounts[i] == unsupported) {
+            if (output.exists()) {
+                std::cerr << "check: the " << unsupported << " channel file rendered, it should have been refused\n";
+                passed = false;
+            }
+        }
+        else {
+            passed = checkRendered(formats, options.inputs.getReference(i), output) && passed;
+        }
+    }
+
+    //only the finished outputs, no temporaries left behind
+    const auto numOutputs = options.outputFolder.getNumberOfChildFiles(juce::File::findFiles);
+    if (numOutputs != options.inputs.size() - 1) {
+        std::cerr << "check: " << numOutputs << " files in the output folder, expected " << options.inputs.size() - 1 << "\n";
+        passed = false;
+    }
+
+    folder.deleteRecursively();
+    std::cout << "check " << (passed ? "passed" : "failed") << "\n";
+    return passed ? 0 : 1;
+}
+
+} //namespace
+
+int main(int argc, char* argv[]) {
+    juce::ScopedJuceInitialiser_GUI juceInit;
+    juce::ArgumentList args(argc, argv);
+
+    if (args.containsOption("--check"))
+        return runCheck();
+
+    Options options;
+    if (!parseOptions(args, options))
+        return args.containsOption("--help|-h") ? 0 : 1;
+
+    juce::MemoryBlock state;
+    if (!options.stateFile.loadFileAsData(state) || !juce::ValueTree::readFromData(state.getData(), state.getSize()).isValid()) {
+        std::cerr << "not a saved eq state: " << options.stateFile.getFullPathName() << "\n";
+        return 1;
+    }
+
+    return renderAll(options, state) == 0 ? 0 : 1;
+}